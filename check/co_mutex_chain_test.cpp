@@ -0,0 +1,120 @@
+#include <chrono>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Checks the chained priority inheritance of co::mutex. Three tasks build a
+chain of two mutexes:
+
+- low takes m2 and holds it until it is released by the driver.
+- mid takes m1 and then blocks on m2.
+- high blocks on m1.
+
+While high waits, both mid and low should run with the priority of high. When
+low releases m2 it returns to its own priority, and when mid releases both
+mutexes it returns to its own priority too, so high gets m1.
+*/
+
+using namespace qOS;
+
+static unsigned long tick = 0uL;
+static co::mutex m1, m2;
+static task driverTask, lowTask, midTask, highTask;
+static bool releaseLow = false;
+static bool highGot = false;
+static int failures = 0;
+
+static qOS::clock_t getTick( void );
+static void expectPriority( const char *what, task &t, const priority_t p );
+static void lowCallback( event_t e );
+static void midCallback( event_t e );
+static void highCallback( event_t e );
+static void driverCallback( event_t e );
+
+static qOS::clock_t getTick( void )
+{
+    return tick;
+}
+
+static void expectPriority( const char *what, task &t, const priority_t p )
+{
+    if ( p != t.getPriority() ) {
+        ++failures;
+        printf( "FAIL " );
+    }
+    printf( "%-28s: %u (expected %u)\r\n", what, static_cast<unsigned>( t.getPriority() ), static_cast<unsigned>( p ) );
+}
+
+static void lowCallback( event_t e )
+{
+    co::reenter() {
+        co::mutexLock( m2 );
+        co::waitUntil( releaseLow );
+        co::mutexUnlock( m2 );
+        (void)e.thisTask().suspend();
+    }
+}
+
+static void midCallback( event_t e )
+{
+    co::reenter() {
+        co::mutexLock( m1 );
+        co::mutexLock( m2 );
+        co::mutexUnlock( m2 );
+        co::mutexUnlock( m1 );
+        (void)e.thisTask().suspend();
+    }
+}
+
+static void highCallback( event_t e )
+{
+    co::reenter() {
+        co::mutexLock( m1 );
+        highGot = true;
+        co::mutexUnlock( m1 );
+        (void)e.thisTask().suspend();
+    }
+}
+
+static void driverCallback( event_t e )
+{
+    Q_UNUSED( e );
+    ++tick;
+    if ( 2uL == tick ) {
+        (void)os.addTask( lowTask, lowCallback, core::LOWEST_PRIORITY, 1_ms, task::PERIODIC );
+    }
+    if ( 4uL == tick ) {
+        (void)os.addTask( midTask, midCallback, core::MEDIUM_PRIORITY, 1_ms, task::PERIODIC );
+    }
+    if ( 6uL == tick ) {
+        (void)os.addTask( highTask, highCallback, core::HIGHEST_PRIORITY, 1_ms, task::PERIODIC );
+    }
+    if ( 10uL == tick ) {
+        expectPriority( "low, owner of m2", lowTask, core::HIGHEST_PRIORITY );
+        expectPriority( "mid, owner of m1", midTask, core::HIGHEST_PRIORITY );
+        releaseLow = true;
+    }
+    if ( 20uL == tick ) {
+        expectPriority( "low, after the release", lowTask, core::LOWEST_PRIORITY );
+        expectPriority( "mid, after the release", midTask, core::MEDIUM_PRIORITY );
+        if ( ( false == highGot ) || m1.isLocked() || m2.isLocked() ) {
+            ++failures;
+            printf( "FAIL " );
+        }
+        printf( "high got m1: %s, m1 %s, m2 %s\r\n", highGot ? "yes" : "no", m1.isLocked() ? "locked" : "free", m2.isLocked() ? "locked" : "free" );
+        os.schedulerRelease();
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+    (void)os.init( getTick, nullptr );
+    (void)os.addTask( driverTask, driverCallback, core::HIGHEST_PRIORITY, clock::IMMEDIATE, task::PERIODIC );
+    os.run();
+
+    return ( 0 == failures ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
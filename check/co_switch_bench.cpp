@@ -0,0 +1,87 @@
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Compares the cost of a suspend/resume round-trip of the co::reenter() macro
+coroutines against the co::stackful backend. Both coroutines only increment a
+counter and give back the control, so the measured time is the switch itself.
+*/
+
+using namespace std;
+
+static const unsigned long ROUNDS = 2000000uL;
+static volatile unsigned long macroCount = 0uL;
+static volatile unsigned long stackfulCount = 0uL;
+static co::context macroCtx;
+
+static void macroCoroutine( void );
+static double measure( void (*fcn)( void ) );
+static void runMacro( void );
+
+static void macroCoroutine( void )
+{
+    co::reenter( macroCtx ) {
+        for ( ;; ) {
+            macroCount = macroCount + 1uL;
+            co::yield();
+        }
+    }
+}
+
+static void runMacro( void )
+{
+    for ( unsigned long i = 0uL ; i < ROUNDS ; ++i ) {
+        macroCoroutine();
+    }
+}
+
+static double measure( void (*fcn)( void ) )
+{
+    const auto start = chrono::steady_clock::now();
+    fcn();
+    const auto elapsed = chrono::steady_clock::now() - start;
+
+    return chrono::duration<double, nano>( elapsed ).count()/static_cast<double>( ROUNDS );
+}
+
+#if defined( Q_CO_STACKFUL_AVAILABLE )
+static co::stackful worker;
+static uint8_t workerStack[ 16384 ];
+
+static void stackfulCoroutine( co::stackful &self, void *arg );
+static void runStackful( void );
+
+static void stackfulCoroutine( co::stackful &self, void *arg )
+{
+    Q_UNUSED( arg );
+    for ( ;; ) {
+        stackfulCount = stackfulCount + 1uL;
+        self.suspend();
+    }
+}
+
+static void runStackful( void )
+{
+    for ( unsigned long i = 0uL ; i < ROUNDS ; ++i ) {
+        (void)worker.resume();
+    }
+}
+#endif
+
+int main( int argc, char *argv[] )
+{
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+
+    printf( "co::reenter  : %8.2f ns/switch\r\n", measure( runMacro ) );
+    #if defined( Q_CO_STACKFUL_AVAILABLE )
+        (void)worker.setup( stackfulCoroutine, nullptr, workerStack, sizeof(workerStack) );
+        printf( "co::stackful : %8.2f ns/switch\r\n", measure( runStackful ) );
+    #else
+        printf( "co::stackful : not available on this build\r\n" );
+    #endif
+
+    return ( ROUNDS == macroCount ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,167 @@
+#include <chrono>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Checks the orthogonal regions of qOS::stateMachine. A container state owns two
+regions, a transition that stays inside a region, a transition that leaves the
+region to the main hierarchy and a transition to a state of the sibling region
+(that should be rejected) are performed. The entry/exit actions are recorded
+in a log that is compared against the expected sequence. It also checks that a
+region can only be attached to one state and that stateMachine::compile()
+counts the states inside the regions against Q_FSM_MAX_NEST_DEPTH.
+*/
+
+using namespace qOS;
+
+static constexpr sm::signalID SIG_GO = sm::SIGNAL_USER( 1 );
+static constexpr sm::signalID SIG_INSIDE = sm::SIGNAL_USER( 2 );
+static constexpr sm::signalID SIG_SIBLING = sm::SIGNAL_USER( 3 );
+static constexpr sm::signalID SIG_OUT = sm::SIGNAL_USER( 4 );
+
+static stateMachine machine;
+static sm::state idle, ortho, after, a1, a2, b1, b2;
+static sm::region r1, r2;
+static stateMachine deep;
+static sm::state holder, x[ Q_FSM_MAX_NEST_DEPTH ];
+static sm::region rd;
+static char trail[ 256 ];
+static int failures = 0;
+
+static void note( const char *s );
+static const char* nameOf( const sm::state *s );
+static sm::status handler( sm::handler_t h );
+static sm::status topHandler( sm::handler_t h );
+static void step( const sm::signalID sig, const sm::state *main, const sm::state *c1, const sm::state *c2, const char *expected );
+static void expect( const bool ok, const char *what );
+
+static void note( const char *s )
+{
+    if ( ( strlen( trail ) + strlen( s ) + 1u ) < sizeof(trail) ) {
+        strcat( trail, s );
+        strcat( trail, " " );
+    }
+}
+
+static const char* nameOf( const sm::state *s )
+{
+    const char *n = "-";
+
+    if ( &idle == s ) { n = "idle"; }
+    else if ( &ortho == s ) { n = "ortho"; }
+    else if ( &after == s ) { n = "after"; }
+    else if ( &a1 == s ) { n = "a1"; }
+    else if ( &a2 == s ) { n = "a2"; }
+    else if ( &b1 == s ) { n = "b1"; }
+    else if ( &b2 == s ) { n = "b2"; }
+    else { n = "-"; }
+
+    return n;
+}
+
+static sm::status handler( sm::handler_t h )
+{
+    const sm::state * const s = &h.thisState();
+    const sm::signalID sig = h.signal();
+    char line[ 32 ];
+
+    if ( sm::signalID::SIGNAL_ENTRY == sig ) {
+        (void)snprintf( line, sizeof(line), "+%s", nameOf( s ) );
+        note( line );
+    }
+    else if ( sm::signalID::SIGNAL_EXIT == sig ) {
+        (void)snprintf( line, sizeof(line), "-%s", nameOf( s ) );
+        note( line );
+    }
+    else if ( ( SIG_GO == sig ) && ( ( &idle == s ) || ( &after == s ) ) ) {
+        h.nextState( ortho );
+    }
+    else if ( ( SIG_INSIDE == sig ) && ( &a1 == s ) ) {
+        h.nextState( a2 );
+    }
+    else if ( ( SIG_SIBLING == sig ) && ( &a2 == s ) ) {
+        h.nextState( b2 ); /*another region, must be rejected*/
+    }
+    else if ( ( SIG_SIBLING == sig ) && ( &b1 == s ) ) {
+        note( "b1:sibling" );
+    }
+    else if ( ( SIG_OUT == sig ) && ( &a2 == s ) ) {
+        h.nextState( after );
+    }
+    else {
+        /*nothing to do*/
+    }
+
+    return sm::status::SUCCESS;
+}
+
+static sm::status topHandler( sm::handler_t h )
+{
+    Q_UNUSED( h );
+    return sm::status::SUCCESS;
+}
+
+static void step( const sm::signalID sig, const sm::state *main, const sm::state *c1, const sm::state *c2, const char *expected )
+{
+    sm::signal_t s;
+
+    s.id = sig;
+    trail[ 0 ] = '\0';
+    (void)machine.run( s );
+    if ( ( main != machine.getCurrent() ) || ( c1 != r1.getCurrent() ) || ( c2 != r2.getCurrent() ) || ( 0 != strcmp( trail, expected ) ) ) {
+        ++failures;
+        printf( "FAIL " );
+    }
+    printf( "%s [%s,%s] : %s\r\n", nameOf( machine.getCurrent() ), nameOf( r1.getCurrent() ), nameOf( r2.getCurrent() ), trail );
+}
+
+static void expect( const bool ok, const char *what )
+{
+    if ( false == ok ) {
+        ++failures;
+        printf( "FAIL " );
+    }
+    printf( "%s\r\n", what );
+}
+
+int main( int argc, char *argv[] )
+{
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+
+    (void)machine.setup( topHandler, idle );
+    (void)machine.add( idle, handler );
+    (void)machine.add( ortho, handler );
+    (void)machine.add( after, handler );
+    (void)r1.add( a1, handler );
+    (void)r1.add( a2, handler );
+    (void)r2.add( b1, handler );
+    (void)r2.add( b2, handler );
+    (void)ortho.addRegion( r1, a1 );
+    (void)ortho.addRegion( r2, b1 );
+    expect( false == after.addRegion( r2, b1 ), "a region is attached to a single state" );
+    expect( machine.compile(), "compile with regions" );
+
+    step( sm::signalID::SIGNAL_NONE, &idle, nullptr, nullptr, "+idle " );
+    step( SIG_GO, &ortho, &a1, &b1, "-idle +ortho +a1 +b1 " );
+    step( SIG_INSIDE, &ortho, &a2, &b1, "-a1 +a2 " );
+    step( SIG_SIBLING, &ortho, &a2, &b1, "b1:sibling " );
+    step( SIG_OUT, &after, nullptr, nullptr, "-a2 -b1 -ortho +after " );
+    step( SIG_GO, &ortho, &a1, &b1, "-after +ortho +a1 +b1 " );
+
+    /*the holder is at depth 2, so the region fits Q_FSM_MAX_NEST_DEPTH - 2 levels*/
+    (void)deep.setup( topHandler, holder );
+    (void)deep.add( holder, handler );
+    (void)rd.add( x[ 0 ], handler );
+    for ( size_t i = 1u ; i < static_cast<size_t>( Q_FSM_MAX_NEST_DEPTH ) - 2u ; ++i ) {
+        (void)x[ i - 1u ].add( x[ i ], handler );
+    }
+    (void)holder.addRegion( rd, x[ 0 ] );
+    expect( deep.compile(), "compile a region at the maximum depth" );
+    (void)x[ Q_FSM_MAX_NEST_DEPTH - 3 ].add( x[ Q_FSM_MAX_NEST_DEPTH - 2 ], handler );
+    expect( false == deep.compile(), "compile a region deeper than Q_FSM_MAX_NEST_DEPTH" );
+
+    return ( 0 == failures ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Throughput benchmark for qOS::mpmcQueue. It reports the cost of a
+send/receive pair on a single thread, next to the same pair on a qOS::queue,
+and the aggregated throughput with several producers and consumers.
+*/
+
+using namespace std;
+
+/*the parentheses keep the function-like co::yield() macro away*/
+static inline void relax( void )
+{
+    ( this_thread::yield )();
+}
+
+static const uint32_t PAIRS = 4000000u;
+
+template <typename Fcn>
+static double nsPerOp( Fcn f, const uint32_t n )
+{
+    const auto start = chrono::steady_clock::now();
+    f();
+    const auto elapsed = chrono::steady_clock::now() - start;
+
+    return chrono::duration<double, nano>( elapsed ).count()/static_cast<double>( n );
+}
+
+static uint32_t plainStorage[ 256 ];
+static queue plain;
+
+#if defined( Q_MPMC_QUEUE_AVAILABLE )
+static mpmcQueue<uint32_t, 256> ring;
+
+static double threaded( const uint32_t producers, const uint32_t consumers )
+{
+    const uint32_t perProducer = PAIRS/producers;
+    const uint32_t total = perProducer*producers;
+    atomic<uint32_t> received( 0u );
+    vector<thread> threads;
+    const auto start = chrono::steady_clock::now();
+
+    for ( uint32_t c = 0u ; c < consumers ; ++c ) {
+        threads.emplace_back( [&received, total]() {
+            uint32_t v;
+            while ( received.load( memory_order_relaxed ) < total ) {
+                if ( ring.receive( v ) ) {
+                    received.fetch_add( 1u, memory_order_relaxed );
+                }
+                else {
+                    relax();
+                }
+            }
+        } );
+    }
+    for ( uint32_t p = 0u ; p < producers ; ++p ) {
+        threads.emplace_back( [perProducer]() {
+            for ( uint32_t i = 0u ; i < perProducer ; ++i ) {
+                while ( !ring.send( i ) ) {
+                    relax();
+                }
+            }
+        } );
+    }
+    for ( auto &t : threads ) {
+        t.join();
+    }
+    const auto elapsed = chrono::steady_clock::now() - start;
+
+    return static_cast<double>( total )/chrono::duration<double>( elapsed ).count()/1.0e6;
+}
+#endif
+
+int main( int argc, char *argv[] )
+{
+    uint32_t v = 0u;
+
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+    (void)plain.setup( plainStorage, sizeof(uint32_t), arraySize( plainStorage ) );
+    printf( "queue     1 thread : %6.2f ns/pair\r\n", nsPerOp( [&v]() {
+        for ( uint32_t i = 0u ; i < PAIRS ; ++i ) {
+            (void)plain.send( &i );
+            (void)plain.receive( &v );
+        }
+    }, PAIRS ) );
+    #if defined( Q_MPMC_QUEUE_AVAILABLE )
+        printf( "mpmcQueue 1 thread : %6.2f ns/pair\r\n", nsPerOp( [&v]() {
+            for ( uint32_t i = 0u ; i < PAIRS ; ++i ) {
+                (void)ring.send( i );
+                (void)ring.receive( v );
+            }
+        }, PAIRS ) );
+        printf( "mpmcQueue 1P/1C    : %6.2f Mitems/s\r\n", threaded( 1u, 1u ) );
+        printf( "mpmcQueue 2P/2C    : %6.2f Mitems/s\r\n", threaded( 2u, 2u ) );
+        printf( "mpmcQueue 4P/4C    : %6.2f Mitems/s\r\n", threaded( 4u, 4u ) );
+    #else
+        printf( "mpmcQueue is not available on this build\r\n" );
+    #endif
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Stress test for qOS::mpmcQueue. Several producer threads send tagged items
+while several consumer threads drain the queue. Every item must be received
+exactly once and the items of each producer must be seen in the order they
+were sent by any single consumer.
+*/
+
+using namespace std;
+
+/*the parentheses keep the function-like co::yield() macro away*/
+static inline void relax( void )
+{
+    ( this_thread::yield )();
+}
+
+#if defined( Q_MPMC_QUEUE_AVAILABLE )
+
+static const uint32_t PRODUCERS = 4u;
+static const uint32_t CONSUMERS = 4u;
+static const uint32_t ITEMS_PER_PRODUCER = 200000u;
+
+struct item_t {
+    uint32_t producer;
+    uint32_t seq;
+};
+
+static mpmcQueue<item_t, 256> ring;
+static atomic<uint32_t> received( 0u );
+static atomic<uint64_t> checksum( 0u );
+static atomic<uint32_t> orderErrors( 0u );
+static vector<atomic<uint32_t>> seen( PRODUCERS*ITEMS_PER_PRODUCER );
+
+static void producer( const uint32_t id );
+static void consumer( void );
+
+static void producer( const uint32_t id )
+{
+    for ( uint32_t i = 0u ; i < ITEMS_PER_PRODUCER ; ++i ) {
+        const item_t it = { id, i };
+
+        while ( !ring.send( it ) ) {
+            relax();
+        }
+    }
+}
+
+static void consumer( void )
+{
+    uint32_t last[ PRODUCERS ];
+    bool first[ PRODUCERS ];
+
+    for ( uint32_t p = 0u ; p < PRODUCERS ; ++p ) {
+        last[ p ] = 0u;
+        first[ p ] = true;
+    }
+    while ( received.load() < PRODUCERS*ITEMS_PER_PRODUCER ) {
+        item_t it;
+
+        if ( ring.receive( it ) ) {
+            if ( !first[ it.producer ] && ( it.seq <= last[ it.producer ] ) ) {
+                ++orderErrors;
+            }
+            first[ it.producer ] = false;
+            last[ it.producer ] = it.seq;
+            ++seen[ it.producer*ITEMS_PER_PRODUCER + it.seq ];
+            checksum += ( static_cast<uint64_t>( it.producer ) << 32u ) + it.seq;
+            ++received;
+        }
+        else {
+            relax();
+        }
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    vector<thread> threads;
+    uint64_t expected = 0u;
+    uint32_t duplicates = 0u;
+
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+    for ( uint32_t c = 0u ; c < CONSUMERS ; ++c ) {
+        threads.emplace_back( consumer );
+    }
+    for ( uint32_t p = 0u ; p < PRODUCERS ; ++p ) {
+        threads.emplace_back( producer, p );
+        for ( uint32_t i = 0u ; i < ITEMS_PER_PRODUCER ; ++i ) {
+            expected += ( static_cast<uint64_t>( p ) << 32u ) + i;
+        }
+    }
+    for ( auto &t : threads ) {
+        t.join();
+    }
+    for ( auto &s : seen ) {
+        if ( 1u != s.load() ) {
+            ++duplicates;
+        }
+    }
+    printf( "received=%u checksum=%s lost/duplicated=%u order errors=%u empty=%d\r\n",
+            received.load(), ( expected == checksum.load() ) ? "ok" : "BAD",
+            duplicates, orderErrors.load(), ring.isEmpty() ? 1 : 0 );
+
+    return ( ( expected == checksum.load() ) && ( 0u == duplicates ) && ( 0u == orderErrors.load() ) && ring.isEmpty() ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main( int argc, char *argv[] )
+{
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+    printf( "mpmcQueue is not available on this build\r\n" );
+    return EXIT_SUCCESS;
+}
+
+#endif
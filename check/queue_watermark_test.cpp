@@ -0,0 +1,128 @@
+#include <chrono>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Checks the watermark edges of qOS::queue. Two queues cross their watermarks
+several times before the attached task gets the chance to run:
+
+- rise: starts below the low mark, goes up, down and up again (HIGH LOW HIGH).
+- fall: starts above the high mark, goes down, up and down again (LOW HIGH LOW).
+
+The attached tasks must receive the edges in the same order they happened, so
+the last edge always matches the final level of the queue.
+*/
+
+using namespace qOS;
+
+static const size_t LENGTH = 8u;
+static const size_t HIGH_MARK = 6u;
+static const size_t LOW_MARK = 2u;
+
+static unsigned long tick = 0uL;
+static queue rise, fall;
+static int riseStorage[ LENGTH ], fallStorage[ LENGTH ];
+static task driverTask, riseTask, fallTask;
+static char riseTrail[ 32 ] = "";
+static char fallTrail[ 32 ] = "";
+
+static qOS::clock_t getTick( void );
+static void fillTo( queue &q, const size_t level );
+static void drainTo( queue &q, const size_t level );
+static void note( event_t e, char *trail, const size_t size );
+static void riseCallback( event_t e );
+static void fallCallback( event_t e );
+static void driverCallback( event_t e );
+
+static qOS::clock_t getTick( void )
+{
+    return tick;
+}
+
+static void fillTo( queue &q, const size_t level )
+{
+    int x = 0;
+
+    while ( q.count() < level ) {
+        (void)q.send( &x );
+    }
+}
+
+static void drainTo( queue &q, const size_t level )
+{
+    int x;
+
+    while ( q.count() > level ) {
+        (void)q.receive( &x );
+    }
+}
+
+static void note( event_t e, char *trail, const size_t size )
+{
+    if ( ( strlen( trail ) + 2u ) < size ) {
+        if ( trigger::byQueueHighWatermark == e.getTrigger() ) {
+            strcat( trail, "H" );
+        }
+        else if ( trigger::byQueueLowWatermark == e.getTrigger() ) {
+            strcat( trail, "L" );
+        }
+        else {
+            /*not a watermark event*/
+        }
+    }
+}
+
+static void riseCallback( event_t e )
+{
+    note( e, riseTrail, sizeof(riseTrail) );
+}
+
+static void fallCallback( event_t e )
+{
+    note( e, fallTrail, sizeof(fallTrail) );
+}
+
+static void driverCallback( event_t e )
+{
+    Q_UNUSED( e );
+    ++tick;
+    if ( 2uL == tick ) {
+        /*all the crossings happen before the attached tasks can run*/
+        fillTo( rise, HIGH_MARK );
+        drainTo( rise, LOW_MARK );
+        fillTo( rise, LENGTH );
+        drainTo( fall, LOW_MARK );
+        fillTo( fall, HIGH_MARK );
+        drainTo( fall, 0u );
+    }
+    if ( 20uL == tick ) {
+        os.schedulerRelease();
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    bool ok;
+
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+    (void)os.init( getTick, nullptr );
+    (void)rise.setup( riseStorage, sizeof(int), LENGTH );
+    (void)fall.setup( fallStorage, sizeof(int), LENGTH );
+    fillTo( fall, LENGTH );
+    (void)rise.setWatermarks( HIGH_MARK, LOW_MARK );
+    (void)fall.setWatermarks( HIGH_MARK, LOW_MARK );
+    (void)os.addTask( driverTask, driverCallback, core::HIGHEST_PRIORITY, clock::IMMEDIATE, task::PERIODIC );
+    (void)os.addTask( riseTask, riseCallback, core::MEDIUM_PRIORITY, clock::IMMEDIATE, task::PERIODIC, taskState::DISABLED_STATE );
+    (void)os.addTask( fallTask, fallCallback, core::MEDIUM_PRIORITY, clock::IMMEDIATE, task::PERIODIC, taskState::DISABLED_STATE );
+    (void)riseTask.attachQueue( rise, queueLinkMode::QUEUE_WATERMARKS );
+    (void)fallTask.attachQueue( fall, queueLinkMode::QUEUE_WATERMARKS );
+    os.run();
+
+    ok = ( 0 == strcmp( riseTrail, "HLH" ) ) && ( 0 == strcmp( fallTrail, "LHL" ) );
+    printf( "rise=%s fall=%s %s\r\n", riseTrail, fallTrail, ok ? "ok" : "BAD" );
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
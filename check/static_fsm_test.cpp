@@ -0,0 +1,147 @@
+#include <chrono>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Instantiates the motor example documented for qOS::sm::staticMachine and checks
+its timeout handling. While RUN_FAST is active, STOP, START and BOOST are
+queued and the 5 seconds timeout expires, so its signal is queued behind them.
+STOP leaves RUN_FAST before that signal is dequeued, so it must be discarded:
+the machine should stay in the new RUN_FAST instead of falling to RUN_SLOW.
+*/
+
+using namespace qOS;
+
+enum : size_t { IDLE, RUN, RUN_SLOW, RUN_FAST };
+const sm::signalID SIG_START = sm::SIGNAL_USER( 1u );
+const sm::signalID SIG_STOP = sm::SIGNAL_USER( 2u );
+const sm::signalID SIG_BOOST = sm::SIGNAL_USER( 3u );
+
+static unsigned long tick = 0uL;
+static int failures = 0;
+
+static qOS::clock_t getTick( void );
+static sm::status idleState( const sm::signal_t &s );
+static sm::status runState( const sm::signal_t &s );
+static sm::status slowState( const sm::signal_t &s );
+static sm::status fastState( const sm::signal_t &s );
+static bool batteryOk( const sm::signal_t &s );
+static const char* nameOf( const size_t id );
+static void step( const char *what, const size_t expected );
+
+using motor_t = sm::staticMachine< IDLE,
+    sm::states<
+        sm::stateOf< IDLE, sm::TOP_STATE, idleState >,
+        sm::stateOf< RUN, sm::TOP_STATE, runState, RUN_SLOW >,
+        sm::stateOf< RUN_SLOW, RUN, slowState >,
+        sm::stateOf< RUN_FAST, RUN, fastState >
+    >,
+    sm::transitions<
+        sm::transitionOf< IDLE, SIG_START, RUN >,
+        sm::transitionOf< RUN, SIG_STOP, IDLE >,
+        sm::transitionOf< RUN_SLOW, SIG_BOOST, RUN_FAST, batteryOk >,
+        sm::transitionOf< RUN_FAST, sm::SIGNAL_TIMEOUT( 0 ), RUN_SLOW >
+    >,
+    sm::timeouts<
+        sm::timeoutOf< RUN_FAST, 0, 5_sec >
+    >
+>;
+
+static motor_t motor;
+static task motorTask;
+static queue signals;
+static sm::signal_t signalStorage[ 8 ];
+
+static qOS::clock_t getTick( void )
+{
+    return tick;
+}
+
+static sm::status idleState( const sm::signal_t &s )
+{
+    Q_UNUSED( s );
+    return sm::status::SUCCESS;
+}
+
+static sm::status runState( const sm::signal_t &s )
+{
+    Q_UNUSED( s );
+    return sm::status::SUCCESS;
+}
+
+static sm::status slowState( const sm::signal_t &s )
+{
+    Q_UNUSED( s );
+    return sm::status::SUCCESS;
+}
+
+static sm::status fastState( const sm::signal_t &s )
+{
+    Q_UNUSED( s );
+    return sm::status::SUCCESS;
+}
+
+static bool batteryOk( const sm::signal_t &s )
+{
+    Q_UNUSED( s );
+    return true;
+}
+
+static const char* nameOf( const size_t id )
+{
+    const char *n = "-";
+
+    if ( IDLE == id ) { n = "IDLE"; }
+    else if ( RUN == id ) { n = "RUN"; }
+    else if ( RUN_SLOW == id ) { n = "RUN_SLOW"; }
+    else if ( RUN_FAST == id ) { n = "RUN_FAST"; }
+    else { n = "-"; }
+
+    return n;
+}
+
+static void step( const char *what, const size_t expected )
+{
+    (void)motor.run();
+    if ( expected != motor.getCurrent() ) {
+        ++failures;
+        printf( "FAIL " );
+    }
+    printf( "%-24s: %s\r\n", what, nameOf( motor.getCurrent() ) );
+}
+
+int main( int argc, char *argv[] )
+{
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+
+    (void)os.init( getTick, nullptr );
+    (void)signals.setup( signalStorage, sizeof(sm::signal_t), 8u );
+    (void)motor.installSignalQueue( signals );
+    /*the documented registration, the scheduler is not started*/
+    (void)os.addTask( motorTask, motor_t::taskCallback, core::MEDIUM_PRIORITY, 10_ms, task::PERIODIC, taskState::ENABLED_STATE, &motor );
+
+    step( "start", IDLE );
+    (void)motor.sendSignal( SIG_START );
+    step( "START", RUN_SLOW );
+    (void)motor.sendSignal( SIG_BOOST );
+    step( "BOOST", RUN_FAST );
+    if ( motor.sendSignal( sm::SIGNAL_TIMEOUT( 0 ) ) ) {
+        ++failures;
+        printf( "FAIL timeout signal accepted from the application\r\n" );
+    }
+    (void)motor.sendSignal( SIG_STOP );
+    (void)motor.sendSignal( SIG_START );
+    (void)motor.sendSignal( SIG_BOOST );
+    tick += 5000uL;
+    step( "5 s, STOP", IDLE );
+    step( "START", RUN_SLOW );
+    step( "BOOST", RUN_FAST );
+    step( "stale timeout", RUN_FAST );
+    tick += 5000uL;
+    step( "5 s, timeout", RUN_SLOW );
+
+    return ( 0 == failures ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
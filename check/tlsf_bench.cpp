@@ -0,0 +1,165 @@
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <QuarkTS.h>
+
+/*
+Latency and fragmentation benchmark for the allocation policies of
+qOS::mem::pool. Both policies run the same pseudo-random workload on a 64 KiB
+area: 400k operations with up to 300 live blocks, 90% of the requests between
+8 and 128 bytes and 10% between 512 and 2048 bytes. Every alloc() and free()
+is timed individually (the figures include the cost of reading the clock),
+and the fragmentation of the free space is sampled every 1000 operations as
+1 - largestFreeBlock/freeBytes. Build with optimizations for stable figures.
+*/
+
+using namespace std;
+
+static const size_t AREA_SIZE = 65536u;
+static const uint32_t OPERATIONS = 400000u;
+static const size_t MAX_LIVE = 300u;
+static const uint32_t SAMPLE_EVERY = 1000u;
+
+static uint64_t area[ AREA_SIZE/sizeof(uint64_t) ];
+
+struct result {
+    double allocAvg;
+    double allocP999;
+    double freeAvg;
+    double freeP999;
+    double fragAvg;
+    double fragMax;
+    size_t failed;
+    size_t freeBlocksAtEnd;
+};
+
+static uint32_t nextRandom( uint32_t &state );
+static size_t requestSize( uint32_t &state );
+static void summarize( vector<double> &t, double &avg, double &p999 );
+static result run( const mem::poolPolicy policy );
+static void report( const char *name, const result &r );
+
+static uint32_t nextRandom( uint32_t &state )
+{
+    /*xorshift32, the same sequence for both policies*/
+    state ^= state << 13u;
+    state ^= state >> 17u;
+    state ^= state << 5u;
+
+    return state;
+}
+
+static size_t requestSize( uint32_t &state )
+{
+    size_t n;
+
+    if ( ( nextRandom( state ) % 10u ) < 9u ) {
+        n = 8u + ( nextRandom( state ) % 121u );
+    }
+    else {
+        n = 512u + ( nextRandom( state ) % 1537u );
+    }
+
+    return n;
+}
+
+static void summarize( vector<double> &t, double &avg, double &p999 )
+{
+    double sum = 0.0;
+
+    for ( const double x : t ) {
+        sum += x;
+    }
+    avg = t.empty() ? 0.0 : sum/static_cast<double>( t.size() );
+    p999 = 0.0;
+    if ( !t.empty() ) {
+        const size_t k = ( t.size()*999u )/1000u;
+
+        nth_element( t.begin(), t.begin() + static_cast<ptrdiff_t>( k ), t.end() );
+        p999 = t[ k ];
+    }
+}
+
+static result run( const mem::poolPolicy policy )
+{
+    mem::pool heap( area, sizeof(area), policy );
+    vector<void*> live;
+    vector<double> allocTimes, freeTimes;
+    uint32_t seed = 0x2545F491u;
+    double fragSum = 0.0;
+    size_t samples = 0u;
+    result r;
+
+    live.reserve( MAX_LIVE );
+    allocTimes.reserve( OPERATIONS );
+    freeTimes.reserve( OPERATIONS );
+    r.fragMax = 0.0;
+    for ( uint32_t i = 0u ; i < OPERATIONS ; ++i ) {
+        const bool doAlloc = ( live.empty() ) || ( ( live.size() < MAX_LIVE ) && ( 0u == ( nextRandom( seed ) & 1u ) ) );
+
+        if ( doAlloc ) {
+            const size_t n = requestSize( seed );
+            const auto t0 = chrono::steady_clock::now();
+            void * const p = heap.alloc( n );
+            const auto t1 = chrono::steady_clock::now();
+
+            allocTimes.push_back( chrono::duration<double, nano>( t1 - t0 ).count() );
+            if ( nullptr != p ) {
+                live.push_back( p );
+            }
+        }
+        else {
+            const size_t k = nextRandom( seed ) % live.size();
+            void * const p = live[ k ];
+            const auto t0 = chrono::steady_clock::now();
+            heap.free( p );
+            const auto t1 = chrono::steady_clock::now();
+
+            freeTimes.push_back( chrono::duration<double, nano>( t1 - t0 ).count() );
+            live[ k ] = live.back();
+            live.pop_back();
+        }
+        if ( 0u == ( ( i + 1u ) % SAMPLE_EVERY ) ) {
+            const mem::poolStats s = heap.getStats();
+
+            if ( s.freeBytes > 0u ) {
+                const double frag = 1.0 - static_cast<double>( s.largestFreeBlock )/static_cast<double>( s.freeBytes );
+
+                fragSum += frag;
+                r.fragMax = max( r.fragMax, frag );
+                ++samples;
+            }
+        }
+    }
+    for ( void * const p : live ) {
+        heap.free( p );
+    }
+    summarize( allocTimes, r.allocAvg, r.allocP999 );
+    summarize( freeTimes, r.freeAvg, r.freeP999 );
+    r.fragAvg = ( samples > 0u ) ? fragSum/static_cast<double>( samples ) : 0.0;
+    r.failed = heap.getStats().failedAllocations;
+    r.freeBlocksAtEnd = heap.getStats().freeBlocks;
+
+    return r;
+}
+
+static void report( const char *name, const result &r )
+{
+    printf( "%-10s %6.1f / %6.1f ns  %6.1f / %6.1f ns  %5.1f%% / %5.1f%%  %7zu  %zu\r\n",
+            name, r.allocAvg, r.allocP999, r.freeAvg, r.freeP999,
+            100.0*r.fragAvg, 100.0*r.fragMax, r.failed, r.freeBlocksAtEnd );
+}
+
+int main( int argc, char *argv[] )
+{
+    Q_UNUSED( argc );
+    Q_UNUSED( argv );
+    printf( "%u ops on %zu bytes, up to %zu live blocks\r\n", static_cast<unsigned>( OPERATIONS ), AREA_SIZE, MAX_LIVE );
+    printf( "policy     alloc avg/p99.9     free avg/p99.9      frag avg/max     failed  free blocks at end\r\n" );
+    report( "FIRST_FIT", run( mem::poolPolicy::FIRST_FIT ) );
+    report( "TLSF", run( mem::poolPolicy::TLSF ) );
+
+    return EXIT_SUCCESS;
+}
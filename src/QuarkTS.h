@@ -51,12 +51,17 @@ This file is part of the QuarkTS++ OS distribution.
 #include "include/clock.hpp"
 #include "include/timer.hpp"
 #include "include/queue.hpp"
+#include "include/channel.hpp"
+#include "include/mpmcqueue.hpp"
 #include "include/fsm.hpp"
+#include "include/staticfsm.hpp"
 #include "include/cli.hpp"
 #include "include/kernel.hpp"
 #include "include/task.hpp"
 #include "include/helper.hpp"
 #include "include/coroutine.hpp"
+#include "include/stackful.hpp"
+#include "include/async.hpp"
 #include "include/memory.hpp"
 #include "include/util.hpp"
 #include "include/bytebuffer.hpp"
@@ -0,0 +1,301 @@
+#include "include/async.hpp"
+
+#if defined( Q_CO_ASYNC_AVAILABLE )
+
+using namespace qOS;
+
+/*! @cond  */
+static const size_t FRAME_HEADER_SIZE = 16u; /*keeps the frame aligned as the pool blocks*/
+/*! @endcond  */
+
+mem::pool *co::async::arena = nullptr; // skipcq: CXX-W2009
+
+/*============================================================================*/
+void* co::async::promise_type::operator new( size_t size ) noexcept
+{
+    mem::pool * const p = arena;
+    uint8_t *raw;
+
+    if ( nullptr != p ) {
+        raw = static_cast<uint8_t*>( p->alloc( size + FRAME_HEADER_SIZE ) );
+    }
+    else {
+        raw = static_cast<uint8_t*>( ::operator new( size + FRAME_HEADER_SIZE, std::nothrow ) );
+    }
+    if ( nullptr != raw ) {
+        /*the owner pool is saved in front of the frame*/
+        (void)memcpy( raw, &p, sizeof(mem::pool*) );
+        raw = &raw[ FRAME_HEADER_SIZE ];
+    }
+
+    return raw;
+}
+/*============================================================================*/
+void co::async::promise_type::operator delete( void *ptr ) noexcept
+{
+    if ( nullptr != ptr ) {
+        /*cstat -CERT-EXP36-C_b*/
+        uint8_t * const raw = static_cast<uint8_t*>( ptr ) - FRAME_HEADER_SIZE;
+        /*cstat +CERT-EXP36-C_b*/
+        mem::pool *p = nullptr;
+
+        (void)memcpy( &p, raw, sizeof(mem::pool*) );
+        if ( nullptr != p ) {
+            p->free( raw );
+        }
+        else {
+            ::operator delete( raw );
+        }
+    }
+}
+/*============================================================================*/
+co::async::async( async &&other ) noexcept : h( other.h ), owner( other.owner )
+{
+    other.h = nullptr;
+    other.owner = nullptr;
+    if ( nullptr != owner ) {
+        (void)owner->setData( this ); /*the task keeps driving the coroutine*/
+    }
+}
+/*============================================================================*/
+co::async& co::async::operator=( async &&other ) noexcept
+{
+    if ( this != &other ) {
+        release();
+        h = other.h;
+        owner = other.owner;
+        other.h = nullptr;
+        other.owner = nullptr;
+        if ( nullptr != owner ) {
+            (void)owner->setData( this );
+        }
+    }
+
+    return *this;
+}
+/*============================================================================*/
+co::async::~async()
+{
+    release();
+}
+/*============================================================================*/
+void co::async::release( void ) noexcept
+{
+    if ( nullptr != owner ) {
+        /*the removal is deferred, detach the frame from the task right now*/
+        (void)owner->setData( nullptr );
+        (void)os.removeTask( *owner );
+        owner = nullptr;
+    }
+    if ( h ) {
+        h.destroy();
+        h = nullptr;
+    }
+}
+/*============================================================================*/
+bool co::async::spawn( task &t, const priority_t p ) noexcept
+{
+    bool retValue = false;
+
+    if ( h && !h.done() && ( nullptr == owner ) ) {
+        retValue = os.addTask( t, taskCallback, p, clock::IMMEDIATE, task::SINGLE_SHOT, taskState::ENABLED_STATE, this );
+        if ( retValue ) {
+            owner = &t;
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool co::async::isDone( void ) const noexcept
+{
+    return ( !h ) || h.done();
+}
+/*============================================================================*/
+void co::async::setArena( mem::pool *p ) noexcept
+{
+    arena = p;
+}
+/*============================================================================*/
+void co::async::step( event_t e ) noexcept
+{
+    if ( h && !h.done() ) {
+        promise_type &pr = h.promise();
+        awaiter * const w = pr.waiting;
+        task &t = e.thisTask();
+
+        if ( ( nullptr == w ) || w->ready( e ) ) {
+            if ( nullptr != w ) {
+                w->disarm( t );
+                pr.waiting = nullptr;
+            }
+            h.resume();
+            if ( h.done() ) {
+                (void)t.disable();
+            }
+            else if ( nullptr != pr.waiting ) {
+                pr.waiting->arm( t );
+            }
+            else {
+                /*plain suspension, resumed on the next activation*/
+            }
+        }
+    }
+}
+/*============================================================================*/
+void co::async::taskCallback( event_t e )
+{
+    /*cstat -CERT-EXP36-C_b*/
+    async * const a = static_cast<async*>( e.TaskData );
+    /*cstat +CERT-EXP36-C_b*/
+    if ( nullptr != a ) {
+        a->step( e );
+    }
+}
+/*============================================================================*/
+bool co::sleepAwaitable::ready( event_t e ) noexcept
+{
+    return ( trigger::byTimeElapsed == e.getTrigger() );
+}
+/*============================================================================*/
+void co::sleepAwaitable::arm( task &tsk ) noexcept
+{
+    (void)tsk.setTime( t );
+    tsk.setIterations( task::SINGLE_SHOT );
+    (void)tsk.enable();
+}
+/*============================================================================*/
+bool co::notificationAwaitable::ready( event_t e ) noexcept
+{
+    const trigger trg = e.getTrigger();
+    const bool retValue = ( trigger::byNotificationSimple == trg ) || ( trigger::byNotificationQueued == trg );
+
+    if ( retValue ) {
+        data = e.EventData;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void co::notificationAwaitable::arm( task &tsk ) noexcept
+{
+    /*notifications reach the task even if it is disabled*/
+    (void)tsk.disable();
+}
+/*============================================================================*/
+bool co::eventFlagsAwaitable::ready( event_t e ) noexcept
+{
+    return ( trigger::byEventFlags == e.getTrigger() ) && os.eventFlagsCheck( e.thisTask(), flags, clearOnExit, checkForAll );
+}
+/*============================================================================*/
+void co::eventFlagsAwaitable::arm( task &tsk ) noexcept
+{
+    (void)tsk.disable();
+}
+/*============================================================================*/
+bool co::semaphoreAwaitable::await_ready( void ) noexcept
+{
+    return sem.tryLock();
+}
+/*============================================================================*/
+bool co::semaphoreAwaitable::ready( event_t e ) noexcept
+{
+    Q_UNUSED( e );
+    return sem.tryLock();
+}
+/*============================================================================*/
+void co::semaphoreAwaitable::arm( task &tsk ) noexcept
+{
+    /*the task is already in the waiter queue of the semaphore*/
+    Q_UNUSED( tsk );
+}
+/*============================================================================*/
+#if ( Q_FSM == 1 )
+co::_fsmWaiter::~_fsmWaiter()
+{
+    detach();
+}
+/*============================================================================*/
+void co::_fsmWaiter::wake( void ) noexcept
+{
+    woken = true;
+    (void)os.notify( notifyMode::SIMPLE, *owner, nullptr );
+}
+/*============================================================================*/
+void co::_fsmWaiter::attach( task &tsk ) noexcept
+{
+    owner = &tsk;
+    woken = false;
+    (void)m.attachWaiter( *this );
+    /*notifications reach the task even if it is disabled*/
+    (void)tsk.disable();
+}
+/*============================================================================*/
+void co::_fsmWaiter::detach( void ) noexcept
+{
+    (void)m.detachWaiter( *this );
+}
+/*============================================================================*/
+bool co::signalAwaitable::onDispatch( sm::signalWaiter &w, const sm::signal_t &s )
+{
+    signalAwaitable &a = static_cast<signalAwaitable&>( static_cast<_fsmWaiter&>( w ) );
+    const bool retValue = ( a.sig == s.id );
+
+    if ( retValue ) {
+        a.data = s.data;
+        a.wake();
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool co::signalAwaitable::ready( event_t e ) noexcept
+{
+    Q_UNUSED( e );
+    return woken;
+}
+/*============================================================================*/
+void co::signalAwaitable::arm( task &tsk ) noexcept
+{
+    attach( tsk );
+}
+/*============================================================================*/
+void co::signalAwaitable::disarm( task &tsk ) noexcept
+{
+    Q_UNUSED( tsk );
+    detach();
+}
+/*============================================================================*/
+bool co::stateAwaitable::onDispatch( sm::signalWaiter &w, const sm::signal_t &sg )
+{
+    stateAwaitable &a = static_cast<stateAwaitable&>( static_cast<_fsmWaiter&>( w ) );
+    const bool retValue = ( &a.s == a.m.getCurrent() );
+
+    Q_UNUSED( sg );
+    if ( retValue ) {
+        a.wake();
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool co::stateAwaitable::ready( event_t e ) noexcept
+{
+    Q_UNUSED( e );
+    return woken;
+}
+/*============================================================================*/
+void co::stateAwaitable::arm( task &tsk ) noexcept
+{
+    attach( tsk );
+}
+/*============================================================================*/
+void co::stateAwaitable::disarm( task &tsk ) noexcept
+{
+    Q_UNUSED( tsk );
+    detach();
+}
+/*============================================================================*/
+#endif
+
+#endif /*Q_CO_ASYNC_AVAILABLE*/
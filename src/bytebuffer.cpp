@@ -2,11 +2,26 @@
 
 using namespace qOS;
 
+/*! @cond  */
+/*publishes the data copied before updating a position*/
+static inline void releaseBarrier( void ) noexcept
+{
+    #if defined( __GNUC__ ) || defined( __clang__ )
+        __atomic_thread_fence( __ATOMIC_RELEASE );
+    #endif
+}
+/*makes the data visible after a position has been read*/
+static inline void acquireBarrier( void ) noexcept
+{
+    #if defined( __GNUC__ ) || defined( __clang__ )
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    #endif
+}
+/*! @endcond  */
+
 /*============================================================================*/
 size_t byteBuffer::checkValidPowerOfTwo( size_t k ) noexcept
 {
-    const size_t r = k;
-
     if ( 0u != ( ( k - 1u ) & k ) ) {
         k--;
         /*cstat -MISRAC++2008-6-5-4 -CERT-INT34-C_a*/
@@ -14,17 +29,18 @@ size_t byteBuffer::checkValidPowerOfTwo( size_t k ) noexcept
             k = k | static_cast<size_t>( k >> i );
         }
         /*cstat +MISRAC++2008-6-5-4 +CERT-INT34-C_a*/
+        /*round down, so the buffer never exceeds the supplied memory*/
         k = static_cast<size_t>( ( k + 1u ) >> 1u );
     }
 
-    return ( k < r ) ? ( k * 2u ) : k;
+    return k;
 }
 /*============================================================================*/
 bool byteBuffer::setup( volatile uint8_t *pBuffer, const size_t bLength ) noexcept
 {
     bool retValue = false;
 
-    if ( ( nullptr != pBuffer ) && ( length > 0u ) ) {
+    if ( ( nullptr != pBuffer ) && ( bLength > 0u ) ) {
         head = 0u;
         tail = 0u;
         buffer = pBuffer;
@@ -40,29 +56,71 @@ bool byteBuffer::put( const uint8_t bData ) noexcept
     bool retValue = false;
 
     if ( false == isFull() ) {
-        buffer[ head % length ] = bData;
-        ++head;
+        const index_t vHead = static_cast<size_t>( head );
+
+        buffer[ vHead & ( length - 1u ) ] = bData;
+        releaseBarrier();
+        head = vHead + 1u;
         retValue = true;
     }
 
     return retValue;
 }
 /*============================================================================*/
-bool byteBuffer::read( void *dst, const size_t n ) noexcept
+size_t byteBuffer::write( const void *src, const size_t n ) noexcept
 {
-    bool retValue = false;
+    size_t k = 0u;
+    size_t contiguous = 0u;
+    uint8_t * const dst = reserve( contiguous );
+
+    if ( ( nullptr != src ) && ( nullptr != dst ) ) {
+        /*cstat -CERT-EXP36-C_b*/
+        const uint8_t * const pData = static_cast<const uint8_t*>( src );
+        /*cstat +CERT-EXP36-C_b*/
+        const size_t room = length - count();
+
+        k = ( n < room ) ? n : room;
+        if ( k > contiguous ) { /*the data wraps around the end of the buffer*/
+            (void)memcpy( dst, pData, contiguous );
+            /*cstat -CERT-EXP36-C_b*/
+            (void)memcpy( const_cast<uint8_t*>( buffer ), &pData[ contiguous ], k - contiguous );
+            /*cstat +CERT-EXP36-C_b*/
+        }
+        else {
+            (void)memcpy( dst, pData, k );
+        }
+        (void)commit( k );
+    }
+
+    return k;
+}
+/*============================================================================*/
+size_t byteBuffer::read( void *dst, const size_t n ) noexcept
+{
+    size_t k = 0u;
+    size_t contiguous = 0u;
+    const uint8_t * const src = peek( contiguous );
 
-    if ( n > 0u ) {
+    if ( ( nullptr != dst ) && ( nullptr != src ) ) {
         /*cstat -CERT-EXP36-C_b*/
         uint8_t * const pData = static_cast<uint8_t*>( dst );
         /*cstat +CERT-EXP36-C_b*/
-        for ( size_t i = 0u ; i < n ; ++i ) {
-            (void)get( &pData[ i ] );
+        const size_t waiting = count();
+
+        k = ( n < waiting ) ? n : waiting;
+        if ( k > contiguous ) { /*the data wraps around the end of the buffer*/
+            (void)memcpy( pData, src, contiguous );
+            /*cstat -CERT-EXP36-C_b*/
+            (void)memcpy( &pData[ contiguous ], const_cast<const uint8_t*>( buffer ), k - contiguous );
+            /*cstat +CERT-EXP36-C_b*/
         }
-        retValue = true;
+        else {
+            (void)memcpy( pData, src, k );
+        }
+        (void)release( k );
     }
 
-    return retValue;
+    return k;
 }
 /*============================================================================*/
 bool byteBuffer::get( uint8_t *dst ) noexcept
@@ -71,8 +129,11 @@ bool byteBuffer::get( uint8_t *dst ) noexcept
 
     if ( false == isEmpty() ) {
         const index_t vTail = static_cast<size_t>( tail );
-        *dst = buffer[ vTail % length ];
-        ++tail;
+
+        acquireBarrier();
+        *dst = buffer[ vTail & ( length - 1u ) ];
+        releaseBarrier();
+        tail = vTail + 1u;
         retValue = true;
     }
 
@@ -81,8 +142,82 @@ bool byteBuffer::get( uint8_t *dst ) noexcept
 /*============================================================================*/
 uint8_t byteBuffer::peek( void ) const noexcept
 {
-    const index_t vTail = static_cast<size_t>( tail );
-    return static_cast<uint8_t>( buffer[ vTail % length ] );
+    uint8_t retValue = 0u;
+
+    if ( false == isEmpty() ) {
+        const index_t vTail = static_cast<size_t>( tail );
+
+        acquireBarrier();
+        retValue = static_cast<uint8_t>( buffer[ vTail & ( length - 1u ) ] );
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+uint8_t* byteBuffer::reserve( size_t &n ) noexcept
+{
+    uint8_t *region = nullptr;
+    const size_t room = length - count();
+
+    n = 0u;
+    if ( room > 0u ) {
+        const size_t index = static_cast<size_t>( head ) & ( length - 1u );
+        const size_t contiguous = length - index;
+
+        acquireBarrier(); /*the consumer is done with the released bytes*/
+        n = ( room < contiguous ) ? room : contiguous;
+        /*cstat -CERT-EXP36-C_b*/
+        region = const_cast<uint8_t*>( &buffer[ index ] );
+        /*cstat +CERT-EXP36-C_b*/
+    }
+
+    return region;
+}
+/*============================================================================*/
+bool byteBuffer::commit( const size_t n ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( n > 0u ) && ( n <= ( length - count() ) ) ) {
+        releaseBarrier();
+        head = static_cast<size_t>( head ) + n;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+const uint8_t* byteBuffer::peek( size_t &n ) const noexcept
+{
+    const uint8_t *region = nullptr;
+    const size_t waiting = count();
+
+    n = 0u;
+    if ( waiting > 0u ) {
+        const size_t index = static_cast<size_t>( tail ) & ( length - 1u );
+        const size_t contiguous = length - index;
+
+        acquireBarrier();
+        n = ( waiting < contiguous ) ? waiting : contiguous;
+        /*cstat -CERT-EXP36-C_b*/
+        region = const_cast<const uint8_t*>( &buffer[ index ] );
+        /*cstat +CERT-EXP36-C_b*/
+    }
+
+    return region;
+}
+/*============================================================================*/
+bool byteBuffer::release( const size_t n ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( n > 0u ) && ( n <= count() ) ) {
+        releaseBarrier(); /*the data is read before the space is handed back*/
+        tail = static_cast<size_t>( tail ) + n;
+        retValue = true;
+    }
+
+    return retValue;
 }
 /*============================================================================*/
 bool byteBuffer::isEmpty( void ) const noexcept
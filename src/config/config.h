@@ -54,6 +54,14 @@
     */
     #define Q_DEFAULT_HEAP_SIZE         ( 0 )
     /**
+    * @brief Memory pool debug records.
+    * @details When enabled, every allocation of a memory pool carries a small
+    * header with its site, tick and sequence number that is reported by
+    * mem::pool::walk().
+    * @note Default value @c 0 @a disabled
+    */
+    #define Q_MEM_DEBUG                 ( 0 )
+    /**
     * @brief Finite State Machine enabler.
     * @details Used to enable or disable the Finite State Machine (FSM) module 
     * @note Default value @c 1 @a enabled
@@ -105,6 +113,15 @@
     * @note Default value @c 1 @a enabled
     */
     #define Q_QUEUES                    ( 1 )
+    /**
+    * @brief Stackful Co-Routines enabler
+    * @details Used to enable or disable the stackful Co-Routines backend
+    * (co::stackful). This backend is only available on hosted POSIX builds,
+    * where it is implemented on top of @c ucontext. On other targets this
+    * setting has no effect.
+    * @note Default value @c 1 @a enabled
+    */
+    #define Q_CO_STACKFUL               ( 1 )
 
     /*================================================================================================================================*/  
 
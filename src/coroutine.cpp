@@ -1,3 +1,4 @@
+#include "include/kernel.hpp"
 #include "include/coroutine.hpp"
 
 using namespace qOS;
@@ -5,7 +6,7 @@ using namespace qOS;
 /*============================================================================*/
 void co::handle::try_restart( void ) noexcept
 {
-    try_set( co::BEGINNING );
+    ctx->reset();
 }
 /*============================================================================*/
 void co::handle::try_suspend( void ) noexcept
@@ -32,19 +33,194 @@ void co::handle::try_set( co::state p ) noexcept
     ctx->label = p;
 }
 /*============================================================================*/
+task* co::_waitQueue::running( void ) noexcept
+{
+    return os.getTaskRunning();
+}
+/*============================================================================*/
+void co::_waitQueue::insert( task &t ) noexcept
+{
+    t.wNext = nullptr;
+    if ( nullptr == head ) {
+        head = &t;
+        tail = &t;
+    }
+    else if ( ( waiterOrder::FIFO == order ) || ( t.priority <= tail->priority ) ) {
+        tail->wNext = &t;
+        tail = &t;
+    }
+    else if ( t.priority > head->priority ) {
+        t.wNext = head;
+        head = &t;
+    }
+    else {
+        task *i = head;
+        /*keep the arrival order between tasks with the same priority*/
+        while ( ( nullptr != i->wNext ) && ( i->wNext->priority >= t.priority ) ) {
+            i = i->wNext;
+        }
+        t.wNext = i->wNext;
+        i->wNext = &t;
+    }
+}
+/*============================================================================*/
+void co::_waitQueue::unlink( const task &t ) noexcept
+{
+    task *prev = nullptr;
+
+    for ( task *i = head ; nullptr != i ; i = i->wNext ) {
+        if ( &t == i ) {
+            if ( nullptr == prev ) {
+                head = i->wNext;
+            }
+            else {
+                prev->wNext = i->wNext;
+            }
+            if ( tail == i ) {
+                tail = prev;
+            }
+            i->wNext = nullptr;
+            break;
+        }
+        prev = i;
+    }
+}
+/*============================================================================*/
+void co::_waitQueue::cancel( task &t ) noexcept
+{
+    /*cstat -CERT-EXP36-C_b*/
+    _waitQueue * const q = static_cast<_waitQueue*>( t.wObj );
+    /*cstat +CERT-EXP36-C_b*/
+
+    if ( nullptr != q ) {
+        const bool granted = t.getFlag( task::BIT_WAIT_GRANTED );
+
+        t.setFlags( task::BIT_WAIT_GRANTED, false );
+        t.wObj = nullptr;
+        if ( granted ) {
+            /*the task was served but it never claimed it, pass it on*/
+            if ( nullptr != q->regrant ) {
+                q->regrant( q->obj );
+            }
+        }
+        else {
+            q->unlink( t );
+        }
+    }
+}
+/*============================================================================*/
+void co::_waitCancel( task &t ) noexcept
+{
+    _waitQueue::cancel( t );
+}
+/*============================================================================*/
+void co::_waitQueue::reposition( task &t ) noexcept
+{
+    /*cstat -CERT-EXP36-C_b*/
+    _waitQueue * const q = static_cast<_waitQueue*>( t.wObj );
+    /*cstat +CERT-EXP36-C_b*/
+
+    if ( ( nullptr != q ) && ( waiterOrder::PRIORITY == q->order ) && ( false == t.getFlag( task::BIT_WAIT_GRANTED ) ) ) {
+        q->unlink( t );
+        q->insert( t );
+    }
+}
+/*============================================================================*/
+void* co::_waitQueue::blockedOn( const task &t, const _waitRegrantFcn_t f ) noexcept
+{
+    void *retValue = nullptr;
+    /*cstat -CERT-EXP36-C_b*/
+    const _waitQueue * const q = static_cast<const _waitQueue*>( t.wObj );
+    /*cstat +CERT-EXP36-C_b*/
+
+    /*a granted task is no longer blocked, it only has to claim the object*/
+    if ( ( nullptr != q ) && ( f == q->regrant ) && ( false == t.getFlag( task::BIT_WAIT_GRANTED ) ) ) {
+        retValue = q->obj;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool co::_waitQueue::pend( task &t ) noexcept
+{
+    bool retValue = false;
+
+    if ( this == t.wObj ) {
+        if ( t.getFlag( task::BIT_WAIT_GRANTED ) ) {
+            t.setFlags( task::BIT_WAIT_GRANTED, false );
+            t.wObj = nullptr;
+            retValue = true;
+        }
+    }
+    else {
+        /*stop the time events, the task will be notified when served*/
+        t.setFlags( task::BIT_WAIT_ENABLED, t.getFlag( task::BIT_ENABLED ) );
+        (void)t.disable();
+        t.wObj = this;
+        insert( t );
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+task* co::_waitQueue::wake( void ) noexcept
+{
+    task * const t = head;
+
+    if ( nullptr != t ) {
+        head = t->wNext;
+        if ( nullptr == head ) {
+            tail = nullptr;
+        }
+        t->wNext = nullptr;
+        t->setFlags( task::BIT_WAIT_GRANTED, true );
+        if ( t->getFlag( task::BIT_WAIT_ENABLED ) ) {
+            (void)t->enable();
+        }
+        (void)os.notify( notifyMode::SIMPLE, *t, this );
+    }
+
+    return t;
+}
+/*============================================================================*/
+bool co::_waitQueue::isPending( const task &t ) const noexcept
+{
+    return ( this == t.wObj );
+}
+/*============================================================================*/
 void co::semaphore::signal( void ) noexcept
 {
-    ++count;
+    /*hand the count directly to the next waiter, if any*/
+    if ( nullptr == waiters.wake() ) {
+        ++count;
+    }
+}
+/*============================================================================*/
+void co::semaphore::regrant( void *obj ) noexcept
+{
+    /*cstat -CERT-EXP36-C_b*/
+    static_cast<semaphore*>( obj )->signal();
+    /*cstat +CERT-EXP36-C_b*/
 }
 /*============================================================================*/
 bool co::semaphore::tryLock( void ) noexcept
 {
     bool retValue = false;
+    task * const t = _waitQueue::running();
 
-    if ( count > static_cast<size_t>( 0u ) ) {
+    if ( ( nullptr != t ) && waiters.isPending( *t ) ) {
+        retValue = waiters.pend( *t );
+    }
+    else if ( ( count > static_cast<size_t>( 0u ) ) && waiters.isEmpty() ) {
         retValue = true; /*break the Wait operation*/
         --count;
     }
+    else if ( nullptr != t ) {
+        (void)waiters.pend( *t );
+    }
+    else {
+        /*nothing to do, outside a task the semaphore can only be polled*/
+    }
 
     return retValue;
 }
@@ -52,5 +228,85 @@ bool co::semaphore::tryLock( void ) noexcept
 void co::semaphore::set( size_t val ) noexcept
 {
     count = val;
+    while ( ( count > static_cast<size_t>( 0u ) ) && ( nullptr != waiters.wake() ) ) {
+        --count;
+    }
+}
+/*============================================================================*/
+bool co::mutex::tryLock( void ) noexcept
+{
+    bool retValue = false;
+    task * const t = _waitQueue::running();
+
+    if ( ( nullptr != t ) && waiters.isPending( *t ) ) {
+        retValue = waiters.pend( *t ); /*the owner was set on unlock*/
+    }
+    else if ( !locked ) {
+        locked = true;
+        owner = t;
+        ownerPriority = ( nullptr != t ) ? t->getPriority() : 0u;
+        retValue = true;
+    }
+    else if ( ( nullptr != t ) && ( t != owner ) ) {
+        (void)waiters.pend( *t );
+        inherit( owner, t->getPriority() );
+    }
+    else {
+        /*nothing to do*/
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void co::mutex::unlock( void ) noexcept
+{
+    if ( locked ) {
+        task *next;
+
+        if ( nullptr != owner ) {
+            (void)owner->setPriority( ownerPriority );
+        }
+        next = waiters.wake();
+        owner = next;
+        if ( nullptr != next ) {
+            /*the highest priority waiter takes the mutex*/
+            ownerPriority = next->getPriority();
+        }
+        else {
+            locked = false;
+        }
+    }
+}
+/*============================================================================*/
+void co::mutex::regrant( void *obj ) noexcept
+{
+    /*cstat -CERT-EXP36-C_b*/
+    static_cast<mutex*>( obj )->unlock();
+    /*cstat +CERT-EXP36-C_b*/
+}
+/*============================================================================*/
+void co::mutex::inherit( task *t, const priority_t p ) noexcept
+{
+    /*follow the chain: owner -> the mutex it waits on -> its owner*/
+    while ( ( nullptr != t ) && ( p > t->getPriority() ) ) {
+        /*cstat -CERT-EXP36-C_b*/
+        const mutex * const m = static_cast<const mutex*>( _waitQueue::blockedOn( *t, &regrant ) );
+        /*cstat +CERT-EXP36-C_b*/
+
+        (void)t->setPriority( p );
+        /*the owner can be waiting on another object*/
+        _waitQueue::reposition( *t );
+        t = ( nullptr != m ) ? m->owner : nullptr;
+    }
+}
+/*============================================================================*/
+task* co::mutex::getOwner( void ) const noexcept
+{
+    return owner;
+}
+/*============================================================================*/
+bool co::mutex::isLocked( void ) const noexcept
+{
+    return locked;
 }
 /*============================================================================*/
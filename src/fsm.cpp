@@ -146,6 +146,523 @@ bool sm::signalPublisher::sendSignal( sm::signalID sig, void *sData, bool isUrge
     return static_cast<bool>( r );
 }
 /*============================================================================*/
+bool sm::signalBroker::setup( list *table, const size_t n ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != table ) && ( n > 0u ) && ( 0u == ( n & ( n - 1u ) ) ) ) {
+        buckets = table;
+        nBuckets = n;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool sm::signalBroker::owns( const sm::subscription &sub ) const noexcept
+{
+    const list * const l = sub.getContainer();
+
+    return ( &wildcards == l ) || ( ( nullptr != buckets ) && ( l >= &buckets[ 0 ] ) && ( l < &buckets[ nBuckets ] ) );
+}
+/*============================================================================*/
+bool sm::signalBroker::subscribe( sm::subscription &sub, stateMachine &m, const sm::signalID s, const uint32_t mask ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != buckets ) && ( s < sm::signalID::MAX_SIGNAL ) ) {
+        if ( nullptr != sub.getContainer() ) {
+            (void)sub.getContainer()->remove( &sub );
+        }
+        sub.machine = &m;
+        sub.sig = s;
+        sub.mask = mask;
+        sub.failures = 0u;
+        sub.lastDelivered = false;
+        if ( 0xFFFFFFFFuL == mask ) {
+            retValue = buckets[ static_cast<size_t>( s ) & ( nBuckets - 1u ) ].insert( &sub );
+        }
+        else {
+            retValue = wildcards.insert( &sub );
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool sm::signalBroker::unsubscribe( sm::subscription &sub ) noexcept
+{
+    bool retValue = false;
+
+    if ( owns( sub ) ) {
+        retValue = sub.getContainer()->remove( &sub );
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+size_t sm::signalBroker::deliver( list &l, const sm::signalID s, void *sData, const bool isUrgent ) noexcept
+{
+    size_t n = 0u;
+
+    for ( auto i = l.begin() ; i.until() ; i++ ) {
+        sm::subscription * const sub = i.get<sm::subscription*>();
+
+        if ( ( static_cast<uint32_t>( s ) & sub->mask ) == ( static_cast<uint32_t>( sub->sig ) & sub->mask ) ) {
+            sub->lastDelivered = sub->machine->sendSignal( s, sData, isUrgent );
+            if ( sub->lastDelivered ) {
+                ++n;
+            }
+            else {
+                ++sub->failures;
+            }
+        }
+    }
+
+    return n;
+}
+/*============================================================================*/
+size_t sm::signalBroker::publish( const sm::signalID s, void *sData, const bool isUrgent ) noexcept
+{
+    size_t n = 0u;
+
+    if ( ( nullptr != buckets ) && ( s < sm::signalID::MAX_SIGNAL ) ) {
+        n = deliver( buckets[ static_cast<size_t>( s ) & ( nBuckets - 1u ) ], s, sData, isUrgent );
+        if ( false == wildcards.isEmpty() ) {
+            n += deliver( wildcards, s, sData, isUrgent );
+        }
+    }
+
+    return n;
+}
+/*============================================================================*/
+bool sm::timeoutWheel::setup( list *table, const size_t n ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != table ) && ( n > 0u ) && ( 0u == ( n & ( n - 1u ) ) ) ) {
+        slots = table;
+        nSlots = n;
+        lastTick = clock::getTick();
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void sm::timeoutWheel::schedule( sm::timeoutEntry &e, const timer &t ) noexcept
+{
+    const qOS::clock_t deadline = clock::getTick() + t.remaining();
+
+    cancel( e );
+    (void)slots[ static_cast<size_t>( deadline ) & ( nSlots - 1u ) ].insert( &e );
+}
+/*============================================================================*/
+void sm::timeoutWheel::cancel( sm::timeoutEntry &e ) noexcept
+{
+    if ( nullptr != e.getContainer() ) {
+        (void)e.getContainer()->remove( &e );
+    }
+}
+/*============================================================================*/
+size_t sm::timeoutWheel::service( void ) noexcept
+{
+    size_t n = 0u;
+
+    if ( nullptr != slots ) {
+        const qOS::clock_t now = clock::getTick();
+        const qOS::clock_t elapsed = now - lastTick;
+        /*visit the slots of the elapsed ticks, each one only once*/
+        const size_t nVisit = ( elapsed < static_cast<qOS::clock_t>( nSlots ) ) ? static_cast<size_t>( elapsed ) : nSlots;
+
+        for ( size_t k = 1u ; k <= nVisit ; ++k ) {
+            list * const slot = &slots[ static_cast<size_t>( lastTick + k ) & ( nSlots - 1u ) ];
+            size_t items = slot->length();
+            /*rescheduled entries are appended, so only the initial ones are checked*/
+            while ( items > 0u ) {
+                /*cstat -CERT-EXP36-C_b*/
+                sm::timeoutEntry * const e = static_cast<sm::timeoutEntry*>( slot->remove( listPosition::AT_FRONT ) );
+                /*cstat +CERT-EXP36-C_b*/
+                stateMachine * const m = e->machine;
+
+                if ( m->timeSpec->timeout[ e->index ].expired() ) {
+                    if ( m->timeoutExpired( e->index ) ) {
+                        ++n;
+                        /*a priority queue notifies the task on every post*/
+                        if ( ( nullptr != m->xNotifyFcn ) && ( nullptr == m->pQueue ) ) {
+                            m->xNotifyFcn( m ); /*wake the task of the state machine*/
+                        }
+                    }
+                }
+                else {
+                    (void)slot->insert( e ); /*more turns of the wheel are needed*/
+                }
+                --items;
+            }
+        }
+        lastTick = now;
+    }
+
+    return n;
+}
+/*============================================================================*/
+bool sm::tracer::setup( sm::traceRecord *buffer, const size_t n ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != buffer ) && ( n > 0u ) ) {
+        ring = buffer;
+        ringSize = n;
+        head = 0u;
+        items = 0u;
+        nLost = 0u;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool sm::tracer::setProfiling( sm::stateProfile *sp, const size_t nS, sm::transitionProfile *tp, const size_t nT ) noexcept
+{
+    sProfiles = sp;
+    nStates = ( nullptr != sp ) ? nS : 0u;
+    tProfiles = tp;
+    nTransitions = ( nullptr != tp ) ? nT : 0u;
+    for ( size_t i = 0u ; i < nStates ; ++i ) {
+        sProfiles[ i ] = sm::stateProfile();
+    }
+    for ( size_t i = 0u ; i < nTransitions ; ++i ) {
+        tProfiles[ i ] = sm::transitionProfile();
+    }
+
+    return ( nStates > 0u ) || ( nTransitions > 0u );
+}
+/*============================================================================*/
+void sm::tracer::record( sm::traceRecord r ) noexcept
+{
+    if ( nullptr != ring ) {
+        r.tick = clock::getTick();
+        if ( items < ringSize ) {
+            ring[ ( head + items ) % ringSize ] = r;
+            ++items;
+        }
+        else { /*full, overwrite the oldest record*/
+            ring[ head ] = r;
+            head = ( head + 1u ) % ringSize;
+            ++nLost;
+        }
+    }
+}
+/*============================================================================*/
+size_t sm::tracer::stateSlot( const sm::state * const s ) const noexcept
+{
+    /*cstat -CERT-INT36-C*/
+    size_t i = ( reinterpret_cast<size_t>( s ) >> 3u ) % nStates;
+    /*cstat +CERT-INT36-C*/
+    size_t slot = nStates;
+
+    /*open addressing, the slots are never released so a free slot ends the probe*/
+    for ( size_t k = 0u ; k < nStates ; ++k ) {
+        if ( ( s == sProfiles[ i ].s ) || ( nullptr == sProfiles[ i ].s ) ) {
+            slot = i;
+            break;
+        }
+        i = ( i + 1u ) % nStates;
+    }
+
+    return slot;
+}
+/*============================================================================*/
+size_t sm::tracer::transitionSlot( const sm::state * const src, const sm::state * const dst ) const noexcept
+{
+    /*cstat -CERT-INT36-C*/
+    size_t i = ( ( reinterpret_cast<size_t>( src ) >> 3u )*31u + ( reinterpret_cast<size_t>( dst ) >> 3u ) ) % nTransitions;
+    /*cstat +CERT-INT36-C*/
+    size_t slot = nTransitions;
+
+    for ( size_t k = 0u ; k < nTransitions ; ++k ) {
+        if ( ( ( src == tProfiles[ i ].source ) && ( dst == tProfiles[ i ].target ) ) || ( nullptr == tProfiles[ i ].source ) ) {
+            slot = i;
+            break;
+        }
+        i = ( i + 1u ) % nTransitions;
+    }
+
+    return slot;
+}
+/*============================================================================*/
+sm::stateProfile* sm::tracer::profileOf( const sm::state * const s, const bool claim ) noexcept
+{
+    sm::stateProfile *p = nullptr;
+
+    if ( nStates > 0u ) {
+        const size_t i = stateSlot( s );
+
+        if ( i < nStates ) {
+            if ( s == sProfiles[ i ].s ) {
+                p = &sProfiles[ i ];
+            }
+            else if ( claim ) {
+                sProfiles[ i ].s = s;
+                p = &sProfiles[ i ];
+            }
+            else {
+                /*not profiled yet*/
+            }
+        }
+    }
+
+    return p;
+}
+/*============================================================================*/
+sm::transitionProfile* sm::tracer::profileOf( const sm::state * const src, const sm::state * const dst, const bool claim ) noexcept
+{
+    sm::transitionProfile *p = nullptr;
+
+    if ( nTransitions > 0u ) {
+        const size_t i = transitionSlot( src, dst );
+
+        if ( i < nTransitions ) {
+            if ( nullptr != tProfiles[ i ].source ) {
+                p = &tProfiles[ i ];
+            }
+            else if ( claim ) {
+                tProfiles[ i ].source = src;
+                tProfiles[ i ].target = dst;
+                p = &tProfiles[ i ];
+            }
+            else {
+                /*not profiled yet*/
+            }
+        }
+    }
+
+    return p;
+}
+/*============================================================================*/
+void sm::tracer::stateEntered( const sm::state * const s ) noexcept
+{
+    sm::stateProfile * const p = profileOf( s, true );
+
+    if ( nullptr != p ) {
+        p->enteredAt = clock::getTick();
+        p->active = true;
+        ++p->entries;
+    }
+}
+/*============================================================================*/
+void sm::tracer::stateExited( const sm::state * const s ) noexcept
+{
+    sm::stateProfile * const p = profileOf( s, false );
+
+    if ( ( nullptr != p ) && p->active ) {
+        p->residency += clock::getTick() - p->enteredAt;
+        p->active = false;
+    }
+}
+/*============================================================================*/
+void sm::tracer::transitionTaken( const sm::state * const src, const sm::state * const dst ) noexcept
+{
+    sm::transitionProfile * const p = profileOf( src, dst, true );
+
+    if ( nullptr != p ) {
+        ++p->count;
+    }
+}
+/*============================================================================*/
+size_t sm::tracer::read( sm::traceRecord *dst, const size_t n ) noexcept
+{
+    size_t k = 0u;
+
+    if ( nullptr != dst ) {
+        while ( ( k < n ) && ( items > 0u ) ) {
+            dst[ k++ ] = ring[ head ];
+            head = ( head + 1u ) % ringSize;
+            --items;
+        }
+    }
+
+    return k;
+}
+/*============================================================================*/
+size_t sm::tracer::count( void ) const noexcept
+{
+    return items;
+}
+/*============================================================================*/
+size_t sm::tracer::lost( void ) const noexcept
+{
+    return nLost;
+}
+/*============================================================================*/
+qOS::clock_t sm::tracer::getResidency( const sm::state &s ) const noexcept
+{
+    qOS::clock_t r = 0u;
+    const size_t i = ( nStates > 0u ) ? stateSlot( &s ) : nStates;
+
+    if ( ( i < nStates ) && ( &s == sProfiles[ i ].s ) ) {
+        const sm::stateProfile * const p = &sProfiles[ i ];
+
+        r = p->residency;
+        if ( p->active ) {
+            r += clock::getTick() - p->enteredAt;
+        }
+    }
+
+    return r;
+}
+/*============================================================================*/
+size_t sm::tracer::getEntries( const sm::state &s ) const noexcept
+{
+    const size_t i = ( nStates > 0u ) ? stateSlot( &s ) : nStates;
+
+    return ( ( i < nStates ) && ( &s == sProfiles[ i ].s ) ) ? sProfiles[ i ].entries : 0u;
+}
+/*============================================================================*/
+size_t sm::tracer::getTransitionCount( const sm::state &src, const sm::state &dst ) const noexcept
+{
+    const size_t i = ( nTransitions > 0u ) ? transitionSlot( &src, &dst ) : nTransitions;
+
+    return ( ( i < nTransitions ) && ( nullptr != tProfiles[ i ].source ) ) ? tProfiles[ i ].count : 0u;
+}
+/*============================================================================*/
+void sm::tracer::clear( void ) noexcept
+{
+    const qOS::clock_t now = clock::getTick();
+
+    head = 0u;
+    items = 0u;
+    nLost = 0u;
+    for ( size_t i = 0u ; i < nStates ; ++i ) {
+        sProfiles[ i ].residency = 0u;
+        sProfiles[ i ].entries = 0u;
+        sProfiles[ i ].enteredAt = now; /*active states keep counting from now*/
+    }
+    for ( size_t i = 0u ; i < nTransitions ; ++i ) {
+        tProfiles[ i ].count = 0u;
+    }
+}
+/*============================================================================*/
+bool sm::signalQueue::setup( sm::signal_t *storage, const size_t n ) noexcept
+{
+    bool retValue = false;
+    const size_t perLevel = n/LEVELS;
+
+    if ( ( nullptr != storage ) && ( perLevel > 0u ) ) {
+        retValue = true;
+        for ( size_t i = 0u ; i < LEVELS ; ++i ) {
+            retValue = lanes[ i ].setup( &storage[ i*perLevel ], sizeof(sm::signal_t), perLevel ) && retValue;
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+queue* sm::signalQueue::front( void ) const noexcept
+{
+    queue *q = nullptr;
+
+    for ( size_t i = LEVELS ; i > 0u ; --i ) {
+        if ( false == lanes[ i - 1u ].isEmpty() ) {
+            q = const_cast<queue*>( &lanes[ i - 1u ] );
+            break;
+        }
+    }
+
+    return q;
+}
+/*============================================================================*/
+bool sm::signalQueue::post( const sm::signal_t &sig, const sm::signalPriority p, const bool isUrgent ) noexcept
+{
+    bool retValue = false;
+    const size_t level = static_cast<size_t>( p );
+
+    if ( level < LEVELS ) {
+        sm::signal_t item = sig;
+        retValue = lanes[ level ].send( &item, isUrgent ? queueSendMode::TO_FRONT : queueSendMode::TO_BACK );
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool sm::signalQueue::receive( sm::signal_t *dst ) noexcept
+{
+    queue * const q = front();
+
+    return ( ( nullptr != q ) && ( nullptr != dst ) ) ? q->receive( dst ) : false;
+}
+/*============================================================================*/
+const sm::signal_t* sm::signalQueue::peek( void ) const noexcept
+{
+    const queue * const q = front();
+
+    /*cstat -CERT-EXP36-C_b*/
+    return ( nullptr != q ) ? static_cast<const sm::signal_t*>( q->peek() ) : nullptr;
+    /*cstat +CERT-EXP36-C_b*/
+}
+/*============================================================================*/
+bool sm::signalQueue::removeFront( void ) noexcept
+{
+    queue * const q = front();
+
+    return ( nullptr != q ) ? q->removeFront() : false;
+}
+/*============================================================================*/
+void sm::signalQueue::reset( void ) noexcept
+{
+    for ( size_t i = 0u ; i < LEVELS ; ++i ) {
+        if ( lanes[ i ].isInitialized() ) {
+            lanes[ i ].reset();
+        }
+    }
+}
+/*============================================================================*/
+size_t sm::signalQueue::count( void ) const noexcept
+{
+    size_t n = 0u;
+
+    for ( size_t i = 0u ; i < LEVELS ; ++i ) {
+        n += lanes[ i ].count();
+    }
+
+    return n;
+}
+/*============================================================================*/
+bool sm::signalQueue::isEmpty( void ) const noexcept
+{
+    return ( nullptr == front() );
+}
+/*============================================================================*/
+bool sm::signalQueue::isFull( void ) const noexcept
+{
+    bool retValue = true;
+
+    for ( size_t i = 0u ; i < LEVELS ; ++i ) {
+        if ( false == lanes[ i ].isFull() ) {
+            retValue = false;
+            break;
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+size_t sm::signalQueue::itemsAvailable( void ) const noexcept
+{
+    size_t n = 0u;
+
+    for ( size_t i = 0u ; i < LEVELS ; ++i ) {
+        n += lanes[ i ].itemsAvailable();
+    }
+
+    return n;
+}
+/*============================================================================*/
+bool sm::signalQueue::isInitialized( void ) const noexcept
+{
+    return lanes[ LEVELS - 1u ].isInitialized();
+}
+/*============================================================================*/
 bool sm::_Handler::timeoutSet( const index_t i, const qOS::duration_t t ) noexcept
 {
     return thisMachine().timeoutSet( i, t );
@@ -163,6 +680,7 @@ bool stateMachine::smSetup( sm::stateCallback_t topFcn, sm::state *init, const s
     source = nullptr;
     mData = pData;
     surrounding = sFcn;
+    compiled = false;
     sm::_Handler::Machine = this;
     sm::_Handler::Data = pData;
     top.topSelf( topFcn, init );
@@ -175,6 +693,9 @@ void sm::state::topSelf( const sm::stateCallback_t topFcn, sm::state *init ) noe
     initState = init;
     sCallback = topFcn;
     parent = nullptr;
+    child = nullptr;
+    sibling = nullptr;
+    depth = 0u;
     tTable = nullptr;
     tEntries = 0u;
     tdef = nullptr;
@@ -183,10 +704,30 @@ void sm::state::topSelf( const sm::stateCallback_t topFcn, sm::state *init ) noe
 /*============================================================================*/
 bool sm::state::subscribe( sm::state *s, const sm::stateCallback_t sFcn, sm::state *init ) noexcept
 {
+    sm::state *d = s;
+
+    if ( nullptr != s->parent ) {
+        s->parent->unlinkChild( s );
+    }
+    /*the depths given by compile() are stale for the whole moved subtree*/
+    while ( nullptr != d ) {
+        d->depth = 0u;
+        if ( nullptr != d->child ) {
+            d = d->child;
+        }
+        else {
+            while ( ( s != d ) && ( nullptr == d->sibling ) ) {
+                d = d->parent;
+            }
+            d = ( s != d ) ? d->sibling : nullptr;
+        }
+    }
     s->lastRunningChild = init;
     s->initState = init;
     s->sCallback = sFcn;
     s->parent = this;
+    s->sibling = child;
+    child = s;
     s->tTable = nullptr;
     s->tEntries = 0u;
     s->tdef = nullptr;
@@ -195,11 +736,82 @@ bool sm::state::subscribe( sm::state *s, const sm::stateCallback_t sFcn, sm::sta
     return true;
 }
 /*============================================================================*/
+void sm::state::unlinkChild( sm::state *s ) noexcept
+{
+    sm::state **link = &child;
+
+    while ( nullptr != *link ) {
+        if ( s == *link ) {
+            *link = s->sibling;
+            s->sibling = nullptr;
+            break;
+        }
+        link = &( *link )->sibling;
+    }
+}
+/*============================================================================*/
+bool stateMachine::compile( void ) noexcept
+{
+    top.depth = 1u; /*the root has depth 1*/
+    compiled = compileTree( &top );
+
+    return compiled;
+}
+/*============================================================================*/
+bool stateMachine::compileTree( sm::state * const root ) noexcept
+{
+    const uint8_t maxDepth = static_cast<uint8_t>( Q_FSM_MAX_NEST_DEPTH );
+    bool retValue = true;
+    sm::state *s = root;
+
+    /*depth-first walk over the child links*/
+    while ( nullptr != s ) {
+        /*a region root takes the depth of its container state*/
+        for ( sm::region *r = s->regions ; nullptr != r ; r = r->next ) {
+            r->root.depth = s->depth;
+            retValue = compileTree( &r->root ) && retValue;
+        }
+        if ( ( nullptr != s->child ) && ( s->depth < maxDepth ) ) {
+            s->child->depth = static_cast<uint8_t>( s->depth + 1u );
+            s = s->child;
+        }
+        else {
+            if ( nullptr != s->child ) {
+                retValue = false; /*the children would exceed the nest depth*/
+            }
+            while ( ( root != s ) && ( nullptr == s->sibling ) ) {
+                s = s->parent;
+            }
+            if ( root == s ) {
+                break;
+            }
+            s = s->sibling;
+            s->depth = static_cast<uint8_t>( s->parent->depth + 1u );
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
 bool sm::state::setTransitions( sm::transition_t *table, size_t n ) noexcept
 {
     bool retValue = false;
 
     if ( ( nullptr != table ) && ( n > 0u ) ) {
+        /*stable insertion sort by signal, entries sharing a signal keep their
+        relative order, so the first-match semantics are preserved*/
+        for ( size_t i = 1u ; i < n ; ++i ) {
+            if ( table[ i ].xSignal < table[ i - 1u ].xSignal ) {
+                const sm::transition_t entry = table[ i ];
+                size_t j = i;
+
+                do {
+                    table[ j ] = table[ j - 1u ];
+                    --j;
+                } while ( ( j > 0u ) && ( entry.xSignal < table[ j - 1u ].xSignal ) );
+                table[ j ] = entry;
+            }
+        }
         tTable = table;
         tEntries = n;
         retValue = true;
@@ -208,6 +820,69 @@ bool sm::state::setTransitions( sm::transition_t *table, size_t n ) noexcept
     return retValue;
 }
 /*============================================================================*/
+bool sm::state::setDeferredSignals( sm::signalID *list, size_t n ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != list ) && ( n > 0u ) ) {
+        for ( size_t i = 1u ; i < n ; ++i ) {
+            const sm::signalID entry = list[ i ];
+            size_t j = i;
+
+            while ( ( j > 0u ) && ( entry < list[ j - 1u ] ) ) {
+                list[ j ] = list[ j - 1u ];
+                --j;
+            }
+            list[ j ] = entry;
+        }
+        dList = list;
+        dEntries = n;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool sm::state::defers( const sm::signalID s ) const noexcept
+{
+    size_t first = 0u;
+    size_t last = dEntries;
+
+    while ( first < last ) {
+        const size_t middle = first + ( ( last - first ) >> 1u );
+
+        if ( dList[ middle ] < s ) {
+            first = middle + 1u;
+        }
+        else {
+            last = middle;
+        }
+    }
+
+    return ( first < dEntries ) && ( s == dList[ first ] );
+}
+/*============================================================================*/
+bool sm::state::addRegion( sm::region &r, sm::state &init ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( &r.root == init.parent ) && ( nullptr == r.owner ) ) {
+        sm::region **link = &regions;
+
+        while ( nullptr != *link ) {
+            link = &( *link )->next;
+        }
+        r.root.initState = &init;
+        r.root.lastRunningChild = &init;
+        r.current = nullptr;
+        r.owner = this;
+        *link = &r;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
 bool stateMachine::installSignalQueue( queue& q ) noexcept
 {
     bool retValue = false;
@@ -215,6 +890,8 @@ bool stateMachine::installSignalQueue( queue& q ) noexcept
         /*cstat -MISRAC++2008-5-14-1*/
         if ( ( true == q.isInitialized() ) && ( sizeof(sm::signal_t) == q.getItemSize() ) ) {
             sQueue = &q; /*install the queue*/
+            pQueue = nullptr;
+            timeoutResync(); /*the queued timeout signals are not known*/
             retValue = true;
         }
         /*cstat +MISRAC++2008-5-14-1*/
@@ -226,21 +903,103 @@ bool stateMachine::installSignalQueue( queue& q ) noexcept
     return retValue;
 }
 /*============================================================================*/
+bool stateMachine::installSignalQueue( sm::signalQueue& q ) noexcept
+{
+    bool retValue = false;
+    #if ( Q_QUEUES == 1 )
+        if ( q.isInitialized() ) {
+            pQueue = &q; /*install the queue*/
+            sQueue = nullptr;
+            timeoutResync(); /*the queued timeout signals are not known*/
+            retValue = true;
+        }
+    #else
+        Q_UNUSED( q );
+    #endif
+
+    return retValue;
+}
+/*============================================================================*/
+bool stateMachine::installDeferQueue( queue& q ) noexcept
+{
+    bool retValue = false;
+    #if ( Q_QUEUES == 1 )
+        /*cstat -MISRAC++2008-5-14-1*/
+        if ( ( true == q.isInitialized() ) && ( sizeof(sm::signal_t) == q.getItemSize() ) ) {
+            dQueue = &q;
+            recallCount = 0u;
+            retValue = true;
+        }
+        /*cstat +MISRAC++2008-5-14-1*/
+    #else
+        Q_UNUSED( q );
+    #endif
+
+    return retValue;
+}
+/*============================================================================*/
+bool stateMachine::deferSignal( const sm::signal_t &sig ) noexcept
+{
+    bool retValue = false;
+    #if ( Q_QUEUES == 1 )
+        if ( ( nullptr != dQueue ) && ( sig.id < sm::signalID::SIGNAL_NONE ) ) {
+            for ( const sm::state *s = current ; nullptr != s ; s = s->parent ) {
+                if ( ( 0u != s->dEntries ) && s->defers( sig.id ) ) {
+                    sm::signal_t item = sig;
+                    retValue = dQueue->send( &item );
+                    if ( retValue ) {
+                        ++nDeferred;
+                    }
+                    break;
+                }
+            }
+        }
+    #else
+        Q_UNUSED( sig );
+    #endif
+
+    return retValue;
+}
+/*============================================================================*/
 void sm::state::sweepTransitionTable( sm::_Handler &h ) const noexcept
 {
-    const size_t n = tEntries;
-    const sm::transition_t *iTransition;
-    
-    for ( size_t i = 0u ; i < n ; ++i ) {
-        iTransition = &tTable[ i ]; /*get the i-element from the table*/
-        if ( ( h.Signal >= sm::signalID::TM_MIN ) && ( h.Signal <= sm::signalID::TM_MAX ) ) {
-            h.SignalData = nullptr; /*ignore signal data on timeout signals*/
+    const sm::signalID sig = h.Signal;
+    size_t first = 0u;
+    size_t last = tEntries;
+
+    if ( ( sig >= sm::signalID::TM_MIN ) && ( sig <= sm::signalID::TM_MAX ) ) {
+        h.SignalData = nullptr; /*ignore signal data on timeout signals*/
+    }
+    /*the table is sorted by signal, find the first entry of the signal*/
+    while ( first < last ) {
+        const size_t middle = first + ( ( last - first ) >> 1u );
+
+        if ( tTable[ middle ].xSignal < sig ) {
+            first = middle + 1u;
+        }
+        else {
+            last = middle;
         }
-        if ( ( h.Signal == iTransition->xSignal ) && ( h.SignalData == iTransition->signalData ) ) { /*table entry match*/
+    }
+    for ( size_t i = first ; ( i < tEntries ) && ( sig == tTable[ i ].xSignal ) ; ++i ) {
+        const sm::transition_t * const iTransition = &tTable[ i ];
+
+        if ( h.SignalData == iTransition->signalData ) { /*table entry match*/
             bool transitionAllowed = true; /*allow the transition by default*/
 
             if ( nullptr != iTransition->guard ) {
+                sm::tracer * const t = h.thisMachine().xTracer;
+
                 transitionAllowed = iTransition->guard( h );
+                if ( nullptr != t ) {
+                    sm::traceRecord r;
+                    r.event = sm::traceEvent::GUARD;
+                    r.sig = sig;
+                    r.source = this;
+                    r.target = iTransition->nextState;
+                    r.guard = transitionAllowed;
+                    t->record( r );
+                }
             }
             if ( transitionAllowed ) {
                 if ( nullptr != iTransition->nextState ) {
@@ -253,20 +1012,31 @@ void sm::state::sweepTransitionTable( sm::_Handler &h ) const noexcept
     }
 }
 /*============================================================================*/
-bool stateMachine::internalSignalSend( sm::signalID sig, void *sData, bool isUrgent ) noexcept
+bool stateMachine::internalSignalSend( sm::signalID sig, void *sData, bool isUrgent, const sm::signalPriority p ) noexcept
 {
     bool retValue = false;
     #if ( Q_QUEUES == 1 )
-        /*check if the state-machine has a signal queue*/
-        if ( nullptr != sQueue ) {
-            sm::signal_t sig_msg;
-            sig_msg.id = sig;
-            sig_msg.data = sData;
+        sm::signal_t sig_msg;
+        sig_msg.id = sig;
+        sig_msg.data = sData;
 
+        /*check if the state-machine has a signal queue*/
+        if ( nullptr != pQueue ) {
+            retValue = pQueue->post( sig_msg, p, isUrgent );
+            /*a priority queue cannot trigger the task, so it is notified here*/
+            if ( retValue && ( nullptr != xNotifyFcn ) ) {
+                xNotifyFcn( this );
+            }
+        }
+        else if ( nullptr != sQueue ) {
             retValue = sQueue->send( &sig_msg, isUrgent ? queueSendMode::TO_FRONT : queueSendMode::TO_BACK );
         }
+        else {
+            /*only the exclusion variable is available*/
+        }
     #else
         Q_UNUSED( isUrgent );
+        Q_UNUSED( p );
     #endif
     /*cppcheck-suppress knownConditionTrueFalse */
     if ( ( false == retValue ) && ( sm::signalID::SIGNAL_NONE == signalNot.id ) ) {
@@ -282,26 +1052,70 @@ bool stateMachine::sendSignal( sm::signalID sig, void *sData, bool isUrgent ) no
 {
     bool retValue = false;
 
-    if ( sig < sm::signalID::SIGNAL_NONE ) {
-        retValue = internalSignalSend( sig, sData, isUrgent );
+    /*timeout signals are only sent by the engine*/
+    if ( sig < sm::signalID::TM_MIN ) {
+        retValue = internalSignalSend( sig, sData, isUrgent, isUrgent ? sm::signalPriority::HIGH : sm::signalPriority::NORMAL );
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool stateMachine::sendSignal( sm::signalID sig, void *sData, const sm::signalPriority p ) noexcept
+{
+    bool retValue = false;
+
+    /*timeout signals are only sent by the engine*/
+    if ( sig < sm::signalID::TM_MIN ) {
+        retValue = internalSignalSend( sig, sData, ( nullptr == pQueue ) && ( sm::signalPriority::HIGH == p ), p );
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void stateMachine::timeoutCheckSignals( void ) noexcept
+{
+    for ( size_t i = 0u ; i < static_cast<size_t>( Q_FSM_MAX_TIMEOUTS ) ; ++i ) {
+        if ( timeSpec->timeout[ i ].expired() ) {
+            (void)timeoutExpired( static_cast<index_t>( i ) );
+        }
+    }
+}
+/*============================================================================*/
+bool stateMachine::timeoutExpired( const index_t i ) noexcept
+{
+    const bool retValue = internalSignalSend( sm::SIGNAL_TIMEOUT( i ), nullptr, false, sm::signalPriority::NORMAL );
+
+    if ( retValue ) {
+        ++timeSpec->pending[ i ];
+    }
+    if ( 0uL  != ( timeSpec->isPeriodic & ( 1uL <<  i ) ) ) {
+        timeSpec->timeout[ i ].reload();
+        if ( nullptr != timeSpec->wheel ) {
+            timeSpec->wheel->schedule( timeSpec->entry[ i ], timeSpec->timeout[ i ] );
+        }
+    }
+    else {
+        timeSpec->timeout[ i ].disarm();
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool stateMachine::timeoutArm( const index_t i, const qOS::duration_t t ) noexcept
+{
+    const bool retValue = timeSpec->timeout[ i ].set( t );
+
+    if ( retValue && ( nullptr != timeSpec->wheel ) ) {
+        timeSpec->wheel->schedule( timeSpec->entry[ i ], timeSpec->timeout[ i ] );
     }
 
     return retValue;
 }
 /*============================================================================*/
-void stateMachine::timeoutCheckSignals( void ) noexcept
+void stateMachine::timeoutDisarm( const index_t i ) noexcept
 {
-    for ( size_t i = 0u ; i < static_cast<size_t>( Q_FSM_MAX_TIMEOUTS ) ; ++i ) {
-        if ( timeSpec->timeout[ i ].expired() ) {
-            (void)sendSignal( sm::SIGNAL_TIMEOUT( i ), nullptr, false );
-            if ( 0uL  != ( timeSpec->isPeriodic & ( 1uL <<  i ) ) ) {
-                timeSpec->timeout[ i ].reload();
-            }
-            else {
-                timeSpec->timeout[ i ].disarm();
-            }
-        }
-    }
+    timeSpec->timeout[ i ].disarm();
+    sm::timeoutWheel::cancel( timeSpec->entry[ i ] );
 }
 /*============================================================================*/
 void stateMachine::timeoutPerformSpecifiedActions( sm::state * const s, sm::signalID sig ) noexcept
@@ -326,12 +1140,11 @@ void stateMachine::timeoutPerformSpecifiedActions( sm::state * const s, sm::sign
             const index_t index = static_cast<index_t>( opt & OPT_INDEX_MASK );
             /*state match and index is valid?*/
             if ( index < static_cast<index_t>( Q_FSM_MAX_TIMEOUTS ) ) {
-                timer * const tmr = &timeSpec->timeout[ index ];
                 const qOS::duration_t tValue = tbl[ i ].xTimeout;
 
                 if ( 0uL != ( opt & setCheck ) ) {
                     if ( 0uL == ( opt & sm::TIMEOUT_KEEP_IF_SET ) ) {
-                        (void)tmr->set( tValue );
+                        (void)timeoutArm( index, tValue );
                     }
                     if ( 0uL != ( opt & sm::TIMEOUT_PERIODIC ) ) {
                         bits::singleSet( timeSpec->isPeriodic, index );
@@ -341,7 +1154,7 @@ void stateMachine::timeoutPerformSpecifiedActions( sm::state * const s, sm::sign
                     }
                 }
                 if ( 0uL != ( opt & resetCheck ) ) {
-                    tmr->disarm();
+                    timeoutDisarm( index );
                 }
             }
         }
@@ -350,15 +1163,38 @@ void stateMachine::timeoutPerformSpecifiedActions( sm::state * const s, sm::sign
 /*============================================================================*/
 bool stateMachine::installTimeoutSpec( sm::timeoutSpec &ts ) noexcept
 {
+    if ( nullptr != timeSpec ) {
+        for ( size_t i = 0u ; i < static_cast<size_t>( Q_FSM_MAX_TIMEOUTS ) ; ++i ) {
+            sm::timeoutWheel::cancel( timeSpec->entry[ i ] );
+        }
+    }
     for ( size_t i = 0u ; i < static_cast<size_t>( Q_FSM_MAX_TIMEOUTS ) ; ++i ) {
         ts.timeout[ i ].disarm();
-        ts.isPeriodic = 0u;
+        sm::timeoutWheel::cancel( ts.entry[ i ] );
+        ts.entry[ i ].machine = this;
+        ts.entry[ i ].index = static_cast<index_t>( i );
+        ts.pending[ i ] = 0u;
+        ts.cancelled[ i ] = 0u;
     }
+    ts.isPeriodic = 0u;
+    ts.wheel = nullptr;
     timeSpec = &ts;
 
     return true;
 }
 /*============================================================================*/
+bool stateMachine::installTimeoutSpec( sm::timeoutSpec &ts, sm::timeoutWheel &w ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != w.slots ) && installTimeoutSpec( ts ) ) {
+        ts.wheel = &w;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
 bool sm::state::setTimeouts( sm::timeoutStateDefinition_t *def, size_t n ) noexcept
 {
     bool retValue = false;
@@ -378,7 +1214,7 @@ bool stateMachine::timeoutSet( const index_t xTimeout, const qOS::duration_t t )
 
     if ( xTimeout < static_cast<index_t>( Q_FSM_MAX_TIMEOUTS ) ) {
         if ( nullptr != timeSpec ) {
-            retValue = timeSpec->timeout[ xTimeout ].set( t );
+            retValue = timeoutArm( xTimeout, t );
         }
     }
 
@@ -390,27 +1226,55 @@ bool stateMachine::timeoutStop( const index_t xTimeout ) noexcept
     bool retValue = false;
 
     if ( ( nullptr != timeSpec ) && ( xTimeout < static_cast<index_t>( Q_FSM_MAX_TIMEOUTS ) ) ) {
-        #if ( Q_QUEUES == 1 )
-            size_t cnt;
-            sm::signal_t xSignal;
-
-            cnt = sQueue->count();
-            while ( 0u != cnt-- ) {
-                if ( true == sQueue->receive( &xSignal ) ) {
-                    if ( xSignal.id != sm::SIGNAL_TIMEOUT( xTimeout ) ) {
-                        /*keep non-timeout signals*/
-                        (void)sQueue->send( &xSignal, queueSendMode::TO_BACK );
-                    }
-                }
-            }
-        #endif
-        timeSpec->timeout[ xTimeout ].disarm();
+        /*the signals already queued are discarded when they are dequeued*/
+        timeSpec->cancelled[ xTimeout ] = timeSpec->pending[ xTimeout ];
+        timeoutDisarm( xTimeout );
         retValue = true;
     }
 
     return retValue;
 }
 /*============================================================================*/
+void stateMachine::timeoutResync( void ) noexcept
+{
+    if ( nullptr != timeSpec ) {
+        for ( size_t i = 0u ; i < static_cast<size_t>( Q_FSM_MAX_TIMEOUTS ) ; ++i ) {
+            timeSpec->pending[ i ] = 0u;
+            timeSpec->cancelled[ i ] = 0u;
+        }
+    }
+}
+/*============================================================================*/
+bool stateMachine::timeoutCancelled( const sm::signalID id ) const noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != timeSpec ) && ( id >= sm::signalID::TM_MIN ) && ( id <= sm::signalID::TM_MAX ) ) {
+        retValue = ( timeSpec->cancelled[ static_cast<size_t>( id - sm::signalID::TM_MIN ) ] > 0u );
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool stateMachine::timeoutDiscard( const sm::signalID id ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != timeSpec ) && ( id >= sm::signalID::TM_MIN ) && ( id <= sm::signalID::TM_MAX ) ) {
+        const size_t i = static_cast<size_t>( id - sm::signalID::TM_MIN );
+
+        if ( timeSpec->pending[ i ] > 0u ) {
+            --timeSpec->pending[ i ];
+        }
+        if ( timeSpec->cancelled[ i ] > 0u ) {
+            --timeSpec->cancelled[ i ];
+            retValue = true;
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
 const sm::state& stateMachine::getTop( void ) const noexcept
 {
     return top;
@@ -463,11 +1327,24 @@ void stateMachine::setSurrounding( const sm::surroundingCallback_t sFcn ) noexce
 /*============================================================================*/
 void stateMachine::transition( sm::state *target, sm::historyMode mHistory ) noexcept
 {
+    if ( nullptr != xTracer ) {
+        sm::traceRecord r;
+        r.event = sm::traceEvent::TRANSITION;
+        r.sig = sm::_Handler::Signal;
+        r.source = source;
+        r.target = target;
+        r.history = mHistory;
+        xTracer->record( r );
+        xTracer->transitionTaken( source, target );
+    }
     exitUpToLCA( levelsToLCA( target ) );
     /*then, handle the required history mode*/
     if ( sm::historyMode::NO_HISTORY == mHistory ) {
         /*just restore the default transition*/
         target->lastRunningChild = target->initState;
+        for ( sm::region *r = target->regions ; nullptr != r ; r = r->next ) {
+            r->root.lastRunningChild = r->root.initState;
+        }
     }
     else if ( sm::historyMode::SHALLOW_HISTORY == mHistory ) {
         if ( nullptr != target->lastRunningChild ) {
@@ -500,6 +1377,24 @@ uint8_t stateMachine::levelsToLCA( sm::state *target ) const noexcept
     if ( source == target ) {
         xLca = 1u; /*recursive transition, only a level needs to be performed*/
     }
+    else if ( compiled && ( 0u != source->depth ) && ( 0u != target->depth ) ) {
+        sm::state *s = source;
+        sm::state *t = target;
+
+        /*bring both states to the same level, then climb together*/
+        while ( s->depth > t->depth ) {
+            s = s->parent;
+            ++xLca;
+        }
+        while ( t->depth > s->depth ) {
+            t = t->parent;
+        }
+        while ( s != t ) {
+            s = s->parent;
+            t = t->parent;
+            ++xLca;
+        }
+    }
     else {
         bool xBreak = false;
         uint8_t n = 0u;
@@ -585,8 +1480,19 @@ sm::state* stateMachine::stateOnExit( sm::state *s ) noexcept
     sm::signal_t SIG_MSG_EXIT;
     SIG_MSG_EXIT.id = sm::signalID::SIGNAL_EXIT;
 
+    if ( nullptr != s->regions ) {
+        exitRegions( s ); /*regions are exited before their container state*/
+    }
     prepareHandler( SIG_MSG_EXIT, s );
     (void)invokeStateActivities( s );
+    if ( nullptr != xTracer ) {
+        xTracer->stateExited( s );
+    }
+    #if ( Q_QUEUES == 1 )
+        if ( ( 0u != s->dEntries ) && ( nullptr != dQueue ) ) {
+            recallCount = dQueue->count(); /*recall the deferred signals*/
+        }
+    #endif
     if ( ( nullptr != timeSpec ) && ( nullptr != s->tdef ) ) {
         timeoutPerformSpecifiedActions( s, sm::signalID::SIGNAL_EXIT );
     }
@@ -602,10 +1508,16 @@ void stateMachine::stateOnEntry( sm::state *s ) noexcept
 
     prepareHandler( SIG_MSG_ENTRY, s );
     (void)invokeStateActivities( s );
+    if ( nullptr != xTracer ) {
+        xTracer->stateEntered( s );
+    }
 
     if ( ( nullptr != timeSpec ) && ( nullptr != s->tdef ) ) {
         timeoutPerformSpecifiedActions( s, sm::signalID::SIGNAL_ENTRY );
     }
+    if ( nullptr != s->regions ) {
+        enterRegions( s );
+    }
 }
 /*============================================================================*/
 sm::state* stateMachine::stateOnStart( sm::state *s ) noexcept
@@ -642,11 +1554,31 @@ sm::status stateMachine::stateOnSignal( sm::state *s, sm::signal_t sig ) noexcep
         /*cstat +CERT-EXP39-C_d*/
     }
     status = invokeStateActivities( s );
+    if ( ( nullptr != xTracer ) && ( sm::signalID::SIGNAL_NONE != sig.id ) ) {
+        sm::traceRecord r;
+        r.event = sm::traceEvent::STATUS;
+        r.sig = sig.id;
+        r.source = s;
+        r.result = status;
+        xTracer->record( r );
+    }
 
     if ( nullptr != sm::_Handler::NextState ) { /*perform the transition if available*/
-        transition( sm::_Handler::NextState, sm::_Handler::TransitionHistory );
-        /*the signal is assumed to be handled if the transition occurs*/
-        status = sm::status::SIGNAL_HANDLED;
+        if ( inScope( sm::_Handler::NextState ) ) {
+            transition( sm::_Handler::NextState, sm::_Handler::TransitionHistory );
+            /*the signal is assumed to be handled if the transition occurs*/
+            status = sm::status::SIGNAL_HANDLED;
+        }
+        else if ( descends( sm::_Handler::NextState, &top ) ) {
+            /*leaving the region, the container state performs the transition*/
+            escTarget = sm::_Handler::NextState;
+            escHistory = sm::_Handler::TransitionHistory;
+            status = sm::status::SIGNAL_HANDLED;
+        }
+        else {
+            /*unreachable from here, e.g. a state of a sibling region*/
+            status = sm::status::FAILURE;
+        }
     }
 
     return status;
@@ -686,6 +1618,119 @@ void stateMachine::traceOnStart( sm::state **entryPath ) noexcept
     }
 }
 /*============================================================================*/
+bool stateMachine::inScope( const sm::state *s ) const noexcept
+{
+    /*the main hierarchy has no scope, its states descend from the top state*/
+    return descends( s, ( nullptr == scope ) ? &top : scope );
+}
+/*============================================================================*/
+bool stateMachine::descends( const sm::state *s, const sm::state * const ancestor ) noexcept
+{
+    bool retValue = false;
+
+    while ( ( false == retValue ) && ( nullptr != s ) ) {
+        retValue = ( ancestor == s );
+        s = s->parent;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void stateMachine::enterRegions( const sm::state * const s ) noexcept
+{
+    sm::state *entryPath[ Q_FSM_MAX_NEST_DEPTH ];
+    sm::state * const xCurrent = current;
+    sm::state * const xNext = next;
+    sm::state * const xSource = source;
+    const sm::state * const xScope = scope;
+
+    for ( sm::region *r = s->regions ; nullptr != r ; r = r->next ) {
+        /*the root of the region has no activities, start from its child*/
+        current = &r->root;
+        scope = &r->root;
+        next = r->root.lastRunningChild;
+        if ( nullptr != next ) {
+            tracePathAndRetraceEntry( entryPath ); // skipcq: CXX-C1000
+            traceOnStart( entryPath ); // skipcq: CXX-C1000
+        }
+        r->current = current;
+    }
+    current = xCurrent;
+    next = xNext;
+    source = xSource;
+    scope = xScope;
+}
+/*============================================================================*/
+void stateMachine::exitRegions( const sm::state * const s ) noexcept
+{
+    for ( sm::region *r = s->regions ; nullptr != r ; r = r->next ) {
+        sm::state *x = r->current;
+
+        while ( ( nullptr != x ) && ( &r->root != x ) ) {
+            x = stateOnExit( x );
+        }
+        r->current = nullptr;
+    }
+}
+/*============================================================================*/
+bool stateMachine::dispatchRegions( sm::state * const s, sm::signal_t sig, sm::state **entryPath ) noexcept
+{
+    bool retValue = false;
+    sm::state * const xCurrent = current;
+    const sm::state * const xScope = scope;
+
+    for ( sm::region *r = s->regions ; nullptr != r ; r = r->next ) {
+        if ( nullptr != r->current ) {
+            current = r->current;
+            scope = &r->root;
+            retValue = propagate( sig, entryPath ) || retValue;
+            r->current = current;
+            if ( nullptr != escTarget ) {
+                break; /*the container state is about to be exited*/
+            }
+        }
+    }
+    current = xCurrent;
+    scope = xScope;
+    source = s;
+
+    return retValue;
+}
+/*============================================================================*/
+bool stateMachine::propagate( sm::signal_t sig, sm::state **entryPath ) noexcept
+{
+    bool retValue = false;
+
+    /*evaluate the hierarchy until the signal is handled*/
+    /*cstat -MISRAC++2008-6-5-2*/
+    for ( sm::state *s = current ; scope != s ; s = s->parent ) {
+        source = s; /* level of outermost event handler */
+        if ( ( nullptr != s->regions ) && dispatchRegions( s, sig, entryPath ) ) {
+            if ( ( nullptr != escTarget ) && inScope( escTarget ) ) {
+                sm::state * const target = escTarget;
+
+                escTarget = nullptr;
+                transition( target, escHistory );
+                tracePathAndRetraceEntry( entryPath ); // skipcq: CXX-C1000
+                traceOnStart( entryPath ); // skipcq: CXX-C1000
+            }
+            retValue = true;
+            break; /* signal processed by the regions*/
+        }
+        if ( sm::status::SIGNAL_HANDLED == stateOnSignal( s, sig ) ) {
+            if ( nullptr != next ) {  /* state transition taken? */
+                /*run entry/start actions in the rest of the hierarchy after transition*/
+                tracePathAndRetraceEntry( entryPath ); // skipcq: CXX-C1000
+                traceOnStart( entryPath ); // skipcq: CXX-C1000
+            }
+            retValue = true;
+            break;/* signal processed */
+        }
+    }
+    /*cstat +MISRAC++2008-6-5-2*/
+    return retValue;
+}
+/*============================================================================*/
 sm::signal_t stateMachine::checkForSignals( sm::signal_t sig ) noexcept
 {
     sm::signal_t xSignal = sig;
@@ -695,7 +1740,7 @@ sm::signal_t stateMachine::checkForSignals( sm::signal_t sig ) noexcept
     timeout-specification object installed. If any timeout expires, the signal
     is put on the available recipient.
     */
-    if ( nullptr != timeSpec ) {
+    if ( ( nullptr != timeSpec ) && ( nullptr == timeSpec->wheel ) ) {
         timeoutCheckSignals();
         /*use the available recipient: signal-queue or the EV*/
     }
@@ -705,51 +1750,266 @@ sm::signal_t stateMachine::checkForSignals( sm::signal_t sig ) noexcept
     queue its empty, the input argument and the exclusion variable are verified.
     */
     #if ( Q_QUEUES == 1 )
-        if ( nullptr != sQueue ) {
+        bool recalled = false;
+
+        if ( recallCount > 0u ) {
+            /*recalled signals go first, they arrived before the queued ones*/
+            --recallCount;
+            recalled = dQueue->receive( &xSignal );
+            if ( false == recalled ) {
+                recallCount = 0u;
+            }
+        }
+        if ( false == recalled ) {
             sm::signal_t receivedSignal;
 
-            if ( sQueue->receive( &receivedSignal ) ) {
-                xSignal = receivedSignal;
+            while ( takeQueued( &receivedSignal ) ) {
+                if ( false == timeoutDiscard( receivedSignal.id ) ) {
+                    xSignal = receivedSignal;
+                    break;
+                }
             }
         }
     #endif
     /*A signal coming from the signal-queue has the higher precedence.*/
     if ( ( sm::signalID::SIGNAL_NONE == xSignal.id ) && ( sm::signalID::SIGNAL_NONE != signalNot.id ) ) {
-        xSignal = signalNot; /*exclusion variable*/
+        if ( false == timeoutDiscard( signalNot.id ) ) {
+            xSignal = signalNot; /*exclusion variable*/
+        }
         signalNot.id = sm::signalID::SIGNAL_NONE;
         signalNot.data = nullptr;
     }
+    #if ( Q_QUEUES == 1 )
+        /*
+        Nothing left to dispatch, so no timeout signal can be pending. This
+        recovers the counters when the queue was emptied from outside.
+        */
+        if ( ( 0u == countQueued() ) && ( sm::signalID::SIGNAL_NONE == signalNot.id ) ) {
+            timeoutResync();
+        }
+    #endif
 
     return xSignal;
 }
 /*============================================================================*/
+size_t stateMachine::pendingSignals( void ) noexcept
+{
+    size_t n = 0u;
+
+    /*stale timeout signals in front are dropped, they will not be dispatched*/
+    if ( timeoutCancelled( signalNot.id ) ) {
+        (void)timeoutDiscard( signalNot.id );
+        signalNot.id = sm::signalID::SIGNAL_NONE;
+        signalNot.data = nullptr;
+    }
+    if ( sm::signalID::SIGNAL_NONE != signalNot.id ) {
+        ++n;
+    }
+    #if ( Q_QUEUES == 1 )
+        const sm::signal_t *s = frontQueued();
+
+        while ( ( nullptr != s ) && timeoutCancelled( s->id ) ) {
+            sm::signal_t stale;
+
+            (void)takeQueued( &stale );
+            (void)timeoutDiscard( stale.id );
+            s = frontQueued();
+        }
+        n += countQueued() + recallCount;
+    #endif
+
+    return n;
+}
+/*============================================================================*/
+bool stateMachine::takeQueued( sm::signal_t *dst ) noexcept
+{
+    bool retValue = false;
+
+    #if ( Q_QUEUES == 1 )
+        if ( nullptr != pQueue ) {
+            retValue = pQueue->receive( dst );
+        }
+        else if ( nullptr != sQueue ) {
+            retValue = sQueue->receive( dst );
+        }
+        else {
+            /*no signal queue installed*/
+        }
+    #else
+        Q_UNUSED( dst );
+    #endif
+
+    return retValue;
+}
+/*============================================================================*/
+const sm::signal_t* stateMachine::frontQueued( void ) const noexcept
+{
+    const sm::signal_t *s = nullptr;
+
+    #if ( Q_QUEUES == 1 )
+        if ( nullptr != pQueue ) {
+            s = pQueue->peek();
+        }
+        else if ( nullptr != sQueue ) {
+            /*cstat -CERT-EXP36-C_b*/
+            s = static_cast<const sm::signal_t*>( sQueue->peek() );
+            /*cstat +CERT-EXP36-C_b*/
+        }
+        else {
+            /*no signal queue installed*/
+        }
+    #endif
+
+    return s;
+}
+/*============================================================================*/
+size_t stateMachine::countQueued( void ) const noexcept
+{
+    size_t n = 0u;
+
+    #if ( Q_QUEUES == 1 )
+        if ( nullptr != pQueue ) {
+            n = pQueue->count();
+        }
+        else if ( nullptr != sQueue ) {
+            n = sQueue->count();
+        }
+        else {
+            /*no signal queue installed*/
+        }
+    #endif
+
+    return n;
+}
+/*============================================================================*/
+void stateMachine::setDrainMode( const size_t maxSignals, const qOS::duration_t budget ) noexcept
+{
+    drainLimit = maxSignals;
+    drainBudget = budget;
+}
+/*============================================================================*/
+bool stateMachine::installTracer( sm::tracer &t ) noexcept
+{
+    removeTracer();
+    xTracer = &t;
+    traceActive( current, nullptr, true );
+
+    return true;
+}
+/*============================================================================*/
+void stateMachine::removeTracer( void ) noexcept
+{
+    if ( nullptr != xTracer ) {
+        traceActive( current, nullptr, false );
+        xTracer = nullptr;
+    }
+}
+/*============================================================================*/
+void stateMachine::traceActive( const sm::state * const from, const sm::state * const stop, const bool entered ) noexcept
+{
+    /*the active states of the main hierarchy and of every active region*/
+    for ( const sm::state *s = from ; ( nullptr != s ) && ( stop != s ) ; s = s->parent ) {
+        for ( const sm::region *r = s->regions ; nullptr != r ; r = r->next ) {
+            if ( nullptr != r->current ) {
+                traceActive( r->current, &r->root, entered );
+            }
+        }
+        if ( entered ) {
+            xTracer->stateEntered( s );
+        }
+        else {
+            xTracer->stateExited( s );
+        }
+    }
+}
+/*============================================================================*/
 bool stateMachine::run( sm::signal_t sig ) noexcept
 {
+    const qOS::clock_t start = ( 1u != drainLimit ) ? clock::getTick() : 0u;
+    const sm::signal_t none;
+    size_t limit = drainLimit;
+    size_t processed = 0u;
     bool retValue = false;
+
+    if ( 0u == limit ) {
+        /*only the signals pending on entry, the ones posted meanwhile wait*/
+        limit = pendingSignals();
+        #if ( Q_QUEUES == 1 )
+            if ( nullptr != dQueue ) {
+                const size_t held = dQueue->count();
+                /*the deferred signals not yet recalled were pending too*/
+                if ( held > recallCount ) {
+                    limit += held - recallCount;
+                }
+            }
+        #endif
+        if ( 0u == limit ) {
+            limit = 1u;
+        }
+    }
+    do {
+        const size_t deferred = nDeferred;
+
+        retValue = dispatch( sig ) || retValue;
+        sig = none;
+        /*a deferred signal is still pending, it will be recalled later*/
+        if ( ( 0u != drainLimit ) || ( deferred == nDeferred ) ) {
+            ++processed;
+        }
+    } while ( ( processed < limit ) && ( pendingSignals() > 0u ) && ( ( clock::NONE == drainBudget ) || ( false == clock::timeDeadLineCheck( start, drainBudget ) ) ) );
+
+    return retValue;
+}
+/*============================================================================*/
+bool stateMachine::dispatch( sm::signal_t sig ) noexcept
+{
     sm::state *entryPath[ Q_FSM_MAX_NEST_DEPTH ];
 
     sig = checkForSignals( sig );
+    if ( ( nullptr != xTracer ) && ( sm::signalID::SIGNAL_NONE != sig.id ) ) {
+        sm::traceRecord r;
+        r.event = sm::traceEvent::SIGNAL;
+        r.sig = sig.id;
+        r.source = current;
+        xTracer->record( r );
+    }
     if ( nullptr == current ) { /*Enter here only once to start the top state*/
         current = &top;
         next = nullptr;
         stateOnEntry( current );
         traceOnStart( entryPath ); // skipcq: CXX-C1000
     }
-    /*evaluate the hierarchy until the signal is handled*/
-    /*cstat -MISRAC++2008-6-5-2*/
-    for ( sm::state *s = current ; nullptr != s ; s = s->parent ) {
-        source = s; /* level of outermost event handler */
-        if ( sm::status::SIGNAL_HANDLED == stateOnSignal( s, sig ) ) {
-            if ( nullptr != next ) {  /* state transition taken? */
-                /*run entry/start actions in the rest of the hierarchy after transition*/
-                tracePathAndRetraceEntry( entryPath ); // skipcq: CXX-C1000
-                traceOnStart( entryPath ); // skipcq: CXX-C1000
-            }
-            retValue = true;
-            break;/* signal processed */
-        }
+    if ( deferSignal( sig ) ) {
+        sig.id = sm::signalID::SIGNAL_NONE; /*kept until a deferring state is exited*/
+        sig.data = nullptr;
     }
-    /*cstat +MISRAC++2008-6-5-2*/
+    const bool retValue = propagate( sig, entryPath );
+
+    if ( false == waiters.isEmpty() ) {
+        notifyWaiters( sig );
+    }
+
     return retValue;
 }
 /*============================================================================*/
+void stateMachine::notifyWaiters( const sm::signal_t &sig ) noexcept
+{
+    for ( auto i = waiters.begin() ; i.until() ; i++ ) {
+        sm::signalWaiter * const w = i.get<sm::signalWaiter*>();
+
+        if ( w->notifyFcn( *w, sig ) ) {
+            (void)waiters.remove( w );
+        }
+    }
+}
+/*============================================================================*/
+bool stateMachine::attachWaiter( sm::signalWaiter &w ) noexcept
+{
+    return waiters.insert( &w );
+}
+/*============================================================================*/
+bool stateMachine::detachWaiter( sm::signalWaiter &w ) noexcept
+{
+    return waiters.remove( &w );
+}
+/*============================================================================*/
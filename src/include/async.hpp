@@ -0,0 +1,424 @@
+#ifndef QOS_CPP_CO_ASYNC
+#define QOS_CPP_CO_ASYNC
+
+#include "config/config.h"
+#include "include/types.hpp"
+#include "include/clock.hpp"
+#include "include/task.hpp"
+#include "include/kernel.hpp"
+#include "include/memory.hpp"
+#include "include/coroutine.hpp"
+
+/*! @cond  */
+#if defined( __cpp_impl_coroutine ) && ( __cpp_impl_coroutine >= 201902L ) && defined( __has_include )
+    #if __has_include( <coroutine> )
+        #define Q_CO_ASYNC_AVAILABLE
+        #include <coroutine>
+        #include <new>
+    #endif
+#endif
+/*! @endcond  */
+
+#if defined( Q_CO_ASYNC_AVAILABLE )
+
+namespace qOS {
+
+    namespace co {
+
+        /** \addtogroup  qcoroutines
+        *  @{
+        */
+
+        /**
+        * @brief The base class of every kernel awaitable used inside a
+        * co::async coroutine.
+        * @details An awaiter configures the triggers of the task that owns the
+        * coroutine when the coroutine suspends on it ( awaiter::arm() ), and it
+        * decides on every activation of that task whether the coroutine can be
+        * resumed ( awaiter::ready() ). The frame is never resumed until the
+        * kernel activates the owner task, so waiting costs nothing but the
+        * regular event checks of the scheduler.
+        */
+        class awaiter {
+            protected:
+                /*! @cond  */
+                awaiter() = default;
+                virtual ~awaiter() {}
+                virtual bool ready( event_t e ) noexcept = 0;
+                virtual void arm( task &t ) noexcept = 0;
+                virtual void disarm( task &t ) noexcept { Q_UNUSED( t ); }
+                /*! @endcond  */
+            friend class async;
+        };
+
+        /**
+        * @brief The return type of a C++20 coroutine driven by the QuarkTS++
+        * kernel.
+        * @details The coroutine is created suspended and runs inside the task
+        * it has been spawned on. Every co_await on a kernel awaitable turns
+        * into task triggers, so the frame is resumed from the kernel dispatch
+        * loop only when the awaited event occurs.
+        * Frames can be allocated from a memory pool by using
+        * co::async::setArena().
+        *
+        * Example:
+        * @code{.c}
+        * co::async blinker( queue &q ) {
+        *     for ( ;; ) {
+        *         uint32_t cmd = co_await co::receive<uint32_t>( q );
+        *         BSP_LED( cmd );
+        *         co_await co::sleep( 500_ms );
+        *     }
+        * }
+        *
+        * task blinkTask;
+        * co::async blink = blinker( commandQueue );
+        *
+        * void main( void ) {
+        *     os.init( HAL_GetTick, nullptr );
+        *     blink.spawn( blinkTask, core::MEDIUM_PRIORITY );
+        *     os.run();
+        * }
+        * @endcode
+        * @note Only available when the compiler supports C++20 coroutines.
+        */
+        class async final {
+            public:
+                /*! @cond  */
+                struct promise_type {
+                    awaiter *waiting{ nullptr };
+                    async get_return_object( void ) noexcept
+                    {
+                        return async( std::coroutine_handle<promise_type>::from_promise( *this ) );
+                    }
+                    static async get_return_object_on_allocation_failure( void ) noexcept
+                    {
+                        return async();
+                    }
+                    std::suspend_always initial_suspend( void ) noexcept { return {}; }
+                    std::suspend_always final_suspend( void ) noexcept { return {}; }
+                    void return_void( void ) noexcept {}
+                    void unhandled_exception( void ) noexcept {}
+                    static void* operator new( size_t size ) noexcept;
+                    static void operator delete( void *ptr ) noexcept;
+                };
+                /*! @endcond  */
+            private:
+                std::coroutine_handle<promise_type> h{};
+                task *owner{ nullptr };
+                static mem::pool *arena; // skipcq: CXX-W2009
+                explicit async( std::coroutine_handle<promise_type> c ) noexcept : h( c ) {}
+                void step( event_t e ) noexcept;
+                void release( void ) noexcept;
+                async( async const& ) = delete;
+                void operator=( async const& ) = delete;
+            public:
+                async() = default;
+                async( async &&other ) noexcept;
+                async& operator=( async &&other ) noexcept;
+                ~async();
+                /**
+                * @brief Add a task to the scheduling scheme that will run the
+                * coroutine. The coroutine starts on the next scheduling cycle.
+                * @param[in] t The task node.
+                * @param[in] p Task priority Value. [0(min) - @c Q_PRIORITY_LEVELS (max)]
+                * @return Returns @c true on success, otherwise returns @c false.
+                */
+                bool spawn( task &t, const priority_t p ) noexcept;
+                /**
+                * @brief Check if the coroutine has finished its execution.
+                * @return @c true if the coroutine body has returned or the frame
+                * could not be allocated, otherwise returns @c false.
+                */
+                bool isDone( void ) const noexcept;
+                /**
+                * @brief Select the memory pool used to allocate the frames of
+                * the coroutines created afterwards.
+                * @param[in] p The memory pool. Pass @c nullptr to use the
+                * global @c new operator.
+                */
+                static void setArena( mem::pool *p ) noexcept;
+                /**
+                * @brief The task callback that drives the coroutine passed as
+                * task argument (event_t::TaskData).
+                * @note co::async::spawn() already uses this callback.
+                * @param[in] e The task event information.
+                */
+                static void taskCallback( event_t e );
+        };
+
+        /*! @cond  */
+        template <typename Derived>
+        class _awaitable : public awaiter {
+            public:
+                inline void await_suspend( std::coroutine_handle<async::promise_type> c ) noexcept
+                {
+                    c.promise().waiting = static_cast<Derived*>( this );
+                }
+        };
+        /*! @endcond  */
+
+        /**
+        * @brief Awaitable that suspends the coroutine for the given amount of
+        * time by using the time trigger of the owner task.
+        * @see co::sleep()
+        */
+        class sleepAwaitable final : public _awaitable<sleepAwaitable> {
+            private:
+                qOS::duration_t t;
+                bool ready( event_t e ) noexcept override;
+                void arm( task &tsk ) noexcept override;
+            public:
+                /*! @cond  */
+                explicit sleepAwaitable( const qOS::duration_t d ) noexcept : t( d ) {}
+                inline bool await_ready( void ) const noexcept { return ( 0u == t ); }
+                inline void await_resume( void ) const noexcept {}
+                /*! @endcond  */
+        };
+
+        /**
+        * @brief Awaitable that suspends the coroutine until an item of type
+        * @a T can be received from a queue.
+        * @see co::receive()
+        */
+        template <typename T>
+        class receiveAwaitable final : public _awaitable<receiveAwaitable<T>> {
+            private:
+                queue &q;
+                T item{};
+                bool ready( event_t e ) noexcept override
+                {
+                    Q_UNUSED( e );
+                    return q.receive( &item );
+                }
+                void arm( task &tsk ) noexcept override
+                {
+                    (void)tsk.attachQueue( q, queueLinkMode::QUEUE_COUNT, 1u );
+                }
+                void disarm( task &tsk ) noexcept override
+                {
+                    (void)tsk.attachQueue( q, queueLinkMode::QUEUE_COUNT, 0u );
+                }
+            public:
+                /*! @cond  */
+                explicit receiveAwaitable( queue &xq ) noexcept : q( xq ) {}
+                inline bool await_ready( void ) noexcept { return q.receive( &item ); }
+                inline T await_resume( void ) noexcept { return item; }
+                /*! @endcond  */
+        };
+
+        /**
+        * @brief Awaitable that suspends the coroutine until the owner task is
+        * notified. The result is the notified event data.
+        * @see co::notification()
+        */
+        class notificationAwaitable final : public _awaitable<notificationAwaitable> {
+            private:
+                void *data{ nullptr };
+                bool ready( event_t e ) noexcept override;
+                void arm( task &tsk ) noexcept override;
+            public:
+                /*! @cond  */
+                notificationAwaitable() = default;
+                inline bool await_ready( void ) const noexcept { return false; }
+                inline void* await_resume( void ) const noexcept { return data; }
+                /*! @endcond  */
+        };
+
+        /**
+        * @brief Awaitable that suspends the coroutine until the event-flags of
+        * the owner task match the requested condition.
+        * @see co::eventFlags()
+        */
+        class eventFlagsAwaitable final : public _awaitable<eventFlagsAwaitable> {
+            private:
+                taskFlag_t flags;
+                bool clearOnExit;
+                bool checkForAll;
+                bool ready( event_t e ) noexcept override;
+                void arm( task &tsk ) noexcept override;
+            public:
+                /*! @cond  */
+                eventFlagsAwaitable( const taskFlag_t f, const bool c, const bool a ) noexcept : flags( f ), clearOnExit( c ), checkForAll( a ) {}
+                inline bool await_ready( void ) const noexcept { return false; }
+                inline void await_resume( void ) const noexcept {}
+                /*! @endcond  */
+        };
+
+        /**
+        * @brief Awaitable that suspends the coroutine until a co::semaphore
+        * can be taken.
+        * @note The owner task waits in the waiter queue of the semaphore and
+        * it is notified when the semaphore is handed to it.
+        * @see co::acquire()
+        */
+        class semaphoreAwaitable final : public _awaitable<semaphoreAwaitable> {
+            private:
+                semaphore &sem;
+                bool ready( event_t e ) noexcept override;
+                void arm( task &tsk ) noexcept override;
+            public:
+                /*! @cond  */
+                explicit semaphoreAwaitable( semaphore &s ) noexcept : sem( s ) {}
+                bool await_ready( void ) noexcept;
+                inline void await_resume( void ) const noexcept {}
+                /*! @endcond  */
+        };
+
+        #if ( Q_FSM == 1 )
+        /*! @cond  */
+        class _fsmWaiter : protected sm::signalWaiter {
+            protected:
+                stateMachine &m;
+                task *owner{ nullptr };
+                bool woken{ false };
+                _fsmWaiter( stateMachine &xm, const sm::signalWaiterFcn_t f ) noexcept : sm::signalWaiter( f ), m( xm ) {}
+                ~_fsmWaiter();
+                void wake( void ) noexcept;
+                void attach( task &tsk ) noexcept;
+                void detach( void ) noexcept;
+        };
+        /*! @endcond  */
+
+        /**
+        * @brief Awaitable that suspends the coroutine until a state machine
+        * dispatches the given signal.
+        * @note The owner task stays disabled while waiting. It is notified
+        * from the dispatch of the state machine, after the signal has been
+        * handled.
+        * @see co::signal()
+        */
+        class signalAwaitable final : public _awaitable<signalAwaitable>, protected _fsmWaiter {
+            private:
+                sm::signalID sig;
+                void *data{ nullptr };
+                static bool onDispatch( sm::signalWaiter &w, const sm::signal_t &s );
+                bool ready( event_t e ) noexcept override;
+                void arm( task &tsk ) noexcept override;
+                void disarm( task &tsk ) noexcept override;
+            public:
+                /*! @cond  */
+                signalAwaitable( stateMachine &xm, const sm::signalID xs ) noexcept : _fsmWaiter( xm, &onDispatch ), sig( xs ) {}
+                inline bool await_ready( void ) const noexcept { return false; }
+                inline void* await_resume( void ) const noexcept { return data; }
+                /*! @endcond  */
+        };
+
+        /**
+        * @brief Awaitable that suspends the coroutine until a state machine
+        * reaches the given state.
+        * @note The owner task stays disabled while waiting. The state is
+        * checked from the dispatch of the state machine, the only place where
+        * the current state can change.
+        * @see co::inState()
+        */
+        class stateAwaitable final : public _awaitable<stateAwaitable>, protected _fsmWaiter {
+            private:
+                sm::state &s;
+                static bool onDispatch( sm::signalWaiter &w, const sm::signal_t &sg );
+                bool ready( event_t e ) noexcept override;
+                void arm( task &tsk ) noexcept override;
+                void disarm( task &tsk ) noexcept override;
+            public:
+                /*! @cond  */
+                stateAwaitable( stateMachine &xm, sm::state &xs ) noexcept : _fsmWaiter( xm, &onDispatch ), s( xs ) {}
+                inline bool await_ready( void ) const noexcept { return ( &s == m.getCurrent() ); }
+                inline void await_resume( void ) const noexcept {}
+                /*! @endcond  */
+        };
+        #endif
+
+        /**
+        * @brief Suspends the coroutine for the specified time.
+        * @param[in] t The amount of time to wait.
+        * @return The awaitable object.
+        */
+        inline sleepAwaitable sleep( const qOS::duration_t t ) noexcept
+        {
+            return sleepAwaitable( t );
+        }
+
+        /**
+        * @brief Suspends the coroutine until an item can be received from the
+        * queue. The item is received by copy.
+        * @pre The queue item size should be equal to @c sizeof(T)
+        * @param[in] q The queue object.
+        * @return The awaitable object. The result of the co_await expression
+        * is the received item.
+        */
+        template <typename T>
+        inline receiveAwaitable<T> receive( queue &q ) noexcept
+        {
+            return receiveAwaitable<T>( q );
+        }
+
+        /**
+        * @brief Suspends the coroutine until the owner task gets a simple or
+        * a queued notification.
+        * @return The awaitable object. The result of the co_await expression
+        * is the notified event data.
+        */
+        inline notificationAwaitable notification( void ) noexcept
+        {
+            return notificationAwaitable();
+        }
+
+        /**
+        * @brief Suspends the coroutine until the requested event-flags of the
+        * owner task are set.
+        * @param[in] flags The flags to check. Can be combined with a bitwise OR.
+        * @param[in] clearOnExit If @c true, the flags will be cleared when the
+        * condition is met.
+        * @param[in] checkForAll If @c true, all the flags should be set,
+        * otherwise any of them.
+        * @return The awaitable object.
+        */
+        inline eventFlagsAwaitable eventFlags( const taskFlag_t flags, const bool clearOnExit = true, const bool checkForAll = false ) noexcept
+        {
+            return eventFlagsAwaitable( flags, clearOnExit, checkForAll );
+        }
+
+        /**
+        * @brief Suspends the coroutine until the semaphore can be taken.
+        * @param[in] s The semaphore object.
+        * @return The awaitable object.
+        */
+        inline semaphoreAwaitable acquire( semaphore &s ) noexcept
+        {
+            return semaphoreAwaitable( s );
+        }
+
+        #if ( Q_FSM == 1 )
+        /**
+        * @brief Suspends the coroutine until the state machine dispatches the
+        * specified signal.
+        * @param[in] m The state machine object.
+        * @param[in] s The signal to wait for.
+        * @return The awaitable object. The result of the co_await expression
+        * is the signal data.
+        */
+        inline signalAwaitable signal( stateMachine &m, const sm::signalID s ) noexcept
+        {
+            return signalAwaitable( m, s );
+        }
+
+        /**
+        * @brief Suspends the coroutine until the state machine reaches the
+        * specified state.
+        * @param[in] m The state machine object.
+        * @param[in] s The state to wait for.
+        * @return The awaitable object.
+        */
+        inline stateAwaitable inState( stateMachine &m, sm::state &s ) noexcept
+        {
+            return stateAwaitable( m, s );
+        }
+        #endif
+
+        /** @}*/
+    }
+}
+
+#endif /*Q_CO_ASYNC_AVAILABLE*/
+
+#endif /*QOS_CPP_CO_ASYNC*/
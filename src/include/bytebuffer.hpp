@@ -13,6 +13,22 @@ namespace qOS {
 
     /**
     * @brief A Byte-sized buffer object
+    * @details The buffer is a ring whose length is a power of two, so the
+    * positions are free-running counters reduced with a mask. The buffer is
+    * lock-free for a single producer and a single consumer, for example a
+    * UART interrupt that writes and a task that reads:
+    * - The producer only modifies the head and the consumer only modifies
+    * the tail.
+    * - The data is copied before the position that publishes it is updated,
+    * with a release barrier in between, and the opposite position is read
+    * with an acquire barrier before the data is touched. The barriers map to
+    * the compiler builtins when available.
+    *
+    * Several producers or several consumers should be serialized by the
+    * application, for example with a critical section.
+    * @note On targets where @c size_t is wider than the native word (e.g. 8
+    * bit MCUs) reading a position is not atomic, so the side that is not the
+    * interrupt should wrap its calls in a critical section.
     */
     class byteBuffer {
         private:
@@ -37,7 +53,8 @@ namespace qOS {
             /**
             * @brief Initialize the Byte-sized buffer
             * @param[in] pBuffer Block of memory or array of data
-            * @param[in] bLength The size of the buffer(Must be a power of two)
+            * @param[in] bLength The size of the buffer. If it is not a power
+            * of two, only the largest power of two that fits will be used.
             * @return @c true on success, otherwise returns @c false.
             */
             bool setup( volatile uint8_t *pBuffer, const size_t bLength ) noexcept;
@@ -48,12 +65,23 @@ namespace qOS {
             */
             bool put( const uint8_t bData ) noexcept;
             /**
-            * @brief Gets n data from the Byte-sized buffer and removes them
-            * @param[out] dst the location where the data-byte will be written
+            * @brief Adds up to @a n bytes to the Byte-sized buffer. The data is
+            * copied with at most two memory copies.
+            * @param[in] src The location of the data to be added
+            * @param[in] n The number of bytes to write
+            * @return The number of bytes written. Can be less than @a n if
+            * there is not enough free space.
+            */
+            size_t write( const void *src, const size_t n ) noexcept;
+            /**
+            * @brief Gets up to @a n bytes from the Byte-sized buffer and removes
+            * them. The data is copied with at most two memory copies.
+            * @param[out] dst the location where the data will be written
             * @param[in] n The number of bytes to read
-            * @return @c true on success, otherwise returns @c false
+            * @return The number of bytes read. Can be less than @a n if there
+            * is not enough data available.
             */
-            bool read( void *dst, const size_t n ) noexcept;
+            size_t read( void *dst, const size_t n ) noexcept;
             /**
             * @brief Gets one data-byte from the front of the Byte-sized buffer, and
             * removes it
@@ -68,6 +96,45 @@ namespace qOS {
             */
             uint8_t peek( void ) const noexcept;
             /**
+            * @brief Get the contiguous free region that starts at the head of
+            * the Byte-sized buffer, so it can be filled in place (e.g. by a DMA
+            * transfer). The data becomes available after byteBuffer::commit()
+            * @pre Should only be called by the producer.
+            * @param[out] n The number of bytes that can be written at the
+            * returned location.
+            * @return A pointer to the free region or @c nullptr if the buffer
+            * is full.
+            */
+            uint8_t* reserve( size_t &n ) noexcept;
+            /**
+            * @brief Publish @a n bytes written in the region obtained with
+            * byteBuffer::reserve()
+            * @pre Should only be called by the producer.
+            * @param[in] n The number of bytes written.
+            * @return @c true on success, @c false if @a n is zero or greater
+            * than the free space.
+            */
+            bool commit( const size_t n ) noexcept;
+            /**
+            * @brief Get the contiguous region of data that starts at the tail of
+            * the Byte-sized buffer, so it can be processed in place. The data is
+            * removed with byteBuffer::release()
+            * @pre Should only be called by the consumer.
+            * @param[out] n The number of bytes available at the returned
+            * location.
+            * @return A pointer to the data or @c nullptr if the buffer is
+            * empty.
+            */
+            const uint8_t* peek( size_t &n ) const noexcept;
+            /**
+            * @brief Remove @a n bytes from the tail of the Byte-sized buffer.
+            * @pre Should only be called by the consumer.
+            * @param[in] n The number of bytes to remove.
+            * @return @c true on success, @c false if @a n is zero or greater
+            * than the number of bytes in the buffer.
+            */
+            bool release( const size_t n ) noexcept;
+            /**
             * @brief Query the empty status of the Byte-sized buffer
             * @return @c true if the Byte-sized buffer is empty, @c false if it
             * is not.
@@ -75,7 +142,7 @@ namespace qOS {
             bool isEmpty( void ) const noexcept;
             /**
             * @brief Query the full status of the Byte-sized buffer
-            * @return @c true if the Byte-sized buffer is empty, @c false if it
+            * @return @c true if the Byte-sized buffer is full, @c false if it
             * is not.
             */
             bool isFull( void ) const noexcept;
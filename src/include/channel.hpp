@@ -0,0 +1,252 @@
+#ifndef QOS_CPP_CHANNEL
+#define QOS_CPP_CHANNEL
+
+#include "include/types.hpp"
+#include "include/queue.hpp"
+#include "include/task.hpp"
+#include "include/critical.hpp"
+
+namespace qOS {
+
+    /** @addtogroup qqueues
+    * @{
+    */
+
+    /**
+    * @brief A pool of fixed-size message buffers.
+    * @details The buffers live inside the object, so the pool does not
+    * allocate memory. Taking and giving back a buffer are O(1) operations
+    * protected by a critical section, so they can be used from interrupts.
+    * Message pools are used together with qOS::channel to pass large
+    * messages between tasks by moving a handle instead of copying the
+    * payload.
+    * @tparam T The type of the message.
+    * @tparam N The number of buffers in the pool.
+    */
+    template <typename T, size_t N>
+    class messagePool final {
+        static_assert( N > 0u, "The pool should have at least one buffer" );
+        private:
+            T blocks[ N ];
+            T *freeStack[ N ];
+            size_t nFree{ N };
+            messagePool( messagePool const& ) = delete;
+            void operator=( messagePool const& ) = delete;
+        public:
+            messagePool() noexcept
+            {
+                for ( size_t i = 0u ; i < N ; ++i ) {
+                    freeStack[ i ] = &blocks[ N - 1u - i ];
+                }
+            }
+            /**
+            * @brief Take a free buffer from the pool. The caller becomes the
+            * owner of the buffer until it is sent through a channel or given
+            * back to the pool.
+            * @return A pointer to the buffer or @c nullptr if there are no
+            * buffers left.
+            */
+            T* take( void ) noexcept
+            {
+                T *b = nullptr;
+
+                critical::enter();
+                if ( nFree > 0u ) {
+                    b = freeStack[ --nFree ];
+                }
+                critical::exit();
+
+                return b;
+            }
+            /**
+            * @brief Return a buffer to the pool.
+            * @param[in] b The buffer previously obtained with messagePool::take()
+            * @return @c true on success, @c false if the buffer does not belong
+            * to the pool.
+            */
+            bool give( T *b ) noexcept
+            {
+                bool retValue = false;
+
+                if ( owns( b ) ) {
+                    critical::enter();
+                    if ( nFree < N ) {
+                        freeStack[ nFree++ ] = b;
+                        retValue = true;
+                    }
+                    critical::exit();
+                }
+
+                return retValue;
+            }
+            /**
+            * @brief Check if a buffer belongs to the pool.
+            * @param[in] b The buffer to check.
+            * @return @c true if @a b is a buffer of the pool, otherwise returns
+            * @c false.
+            */
+            bool owns( const T *b ) const noexcept
+            {
+                return ( b >= &blocks[ 0 ] ) && ( b <= &blocks[ N - 1u ] );
+            }
+            /**
+            * @brief Get the number of free buffers.
+            * @return The number of buffers that can be taken.
+            */
+            size_t available( void ) const noexcept
+            {
+                return nFree;
+            }
+    };
+
+    /**
+    * @brief A typed channel to transfer the ownership of messages between
+    * tasks.
+    * @details A channel is a queue of handles: sending a message moves the
+    * pointer to its buffer (usually taken from a qOS::messagePool), so the
+    * cost of a transfer does not depend on the size of the message. After a
+    * successful channel::send() the sender loses the ownership of the buffer
+    * and the handle is cleared. The receiver owns the buffer and should give
+    * it back to the pool when it is done. Channels can be attached to a task
+    * with the same triggers available for queues.
+    *
+    * Example:
+    * @code{.c}
+    * messagePool<frame_t, 4> frames;
+    * channel<frame_t, 4> rxFrames;
+    *
+    * void rxTask_Callback( event_t e ) {
+    *     frame_t *f = frames.take();
+    *     if ( nullptr != f ) {
+    *         readFrame( f );
+    *         rxFrames.send( f );
+    *     }
+    * }
+    *
+    * void parserTask_Callback( event_t e ) {
+    *     frame_t *f = rxFrames.fromEvent( e );
+    *     if ( nullptr != f ) {
+    *         parseFrame( f );
+    *         frames.give( f );
+    *     }
+    * }
+    *
+    * rxFrames.attach( parserTask );
+    * @endcode
+    * @tparam T The type of the message.
+    * @tparam N The maximum number of messages that the channel can hold.
+    */
+    template <typename T, size_t N>
+    class channel final {
+        static_assert( N > 0u, "The channel should hold at least one message" );
+        private:
+            queue q;
+            T *slots[ N ];
+            channel( channel const& ) = delete;
+            void operator=( channel const& ) = delete;
+        public:
+            channel() noexcept
+            {
+                (void)q.setup( slots, sizeof(T*), N );
+            }
+            /**
+            * @brief Send a message through the channel.
+            * @param[in,out] msg The handle of the message. On success, the
+            * ownership is transferred to the channel and @a msg is set to
+            * @c nullptr.
+            * @param[in] pos Can take the value @c queueSendMode::TO_BACK
+            * (default) or @c queueSendMode::TO_FRONT
+            * @return @c true on success, @c false if the channel is full or
+            * @a msg is @c nullptr.
+            */
+            bool send( T* &msg, const queueSendMode pos = queueSendMode::TO_BACK ) noexcept
+            {
+                bool retValue = false;
+
+                if ( nullptr != msg ) {
+                    retValue = q.send( &msg, pos );
+                    if ( retValue ) {
+                        msg = nullptr;
+                    }
+                }
+
+                return retValue;
+            }
+            /**
+            * @brief Receive the message at the front of the channel. The caller
+            * becomes the owner of the message.
+            * @return The handle of the message or @c nullptr if the channel is
+            * empty.
+            */
+            T* receive( void ) noexcept
+            {
+                T *msg = nullptr;
+
+                (void)q.receive( &msg );
+
+                return msg;
+            }
+            /**
+            * @brief Get the message delivered to a task attached in the
+            * queueLinkMode::QUEUE_RECEIVER mode. The handle is removed from the
+            * channel by the kernel after the task is served, so the caller
+            * becomes the owner of the message.
+            * @note Should be called on every activation of the receiver task,
+            * otherwise the message is lost.
+            * @param[in] e The task event information.
+            * @return The handle of the message or @c nullptr if the task was
+            * not triggered by this channel.
+            */
+            T* fromEvent( event_t e ) const noexcept
+            {
+                T *msg = nullptr;
+                /*cstat -CERT-EXP36-C_b*/
+                if ( ( trigger::byQueueReceiver == e.getTrigger() ) && ( nullptr != e.EventData ) && ( q.peek() == e.EventData ) ) {
+                    msg = *static_cast<T**>( e.EventData );
+                }
+                /*cstat +CERT-EXP36-C_b*/
+                return msg;
+            }
+            /**
+            * @brief Attach the channel to a task using one of the queue
+            * triggers.
+            * @see task::attachQueue()
+            * @param[in] t The task that will be triggered by the channel.
+            * @param[in] mode The attaching mode.
+            * @param[in] arg The mode argument. See task::attachQueue()
+            * @return @c true on success, otherwise returns @c false.
+            */
+            bool attach( task &t, const queueLinkMode mode = queueLinkMode::QUEUE_RECEIVER, const size_t arg = 1u ) noexcept
+            {
+                return t.attachQueue( q, mode, arg );
+            }
+            /**
+            * @brief Returns the number of messages in the channel.
+            * @return The number of messages waiting.
+            */
+            size_t count( void ) const noexcept
+            {
+                return q.count();
+            }
+            /**
+            * @brief Returns the empty status of the channel.
+            * @return @c true if the channel is empty, otherwise returns @c false.
+            */
+            bool isEmpty( void ) const noexcept
+            {
+                return q.isEmpty();
+            }
+            /**
+            * @brief Returns the full status of the channel.
+            * @return @c true if the channel is full, otherwise returns @c false.
+            */
+            bool isFull( void ) const noexcept
+            {
+                return q.isFull();
+            }
+    };
+
+    /** @}*/
+}
+
+#endif /*QOS_CPP_CHANNEL*/
@@ -7,6 +7,10 @@
 
 namespace qOS {
 
+    /*! @cond  */
+    class task;
+    /*! @endcond  */
+
     /**
     * @brief CoRoutines interfaces.
     */
@@ -80,11 +84,67 @@ namespace qOS {
             friend class co::_coContext;
         };
 
-        /** @brief A Co-Routine Semaphore*/
+        /**
+        * @brief The order in which the tasks waiting on a co::semaphore or a
+        * co::mutex are woken up.
+        */
+        enum class waiterOrder : uint8_t {
+            FIFO,       /**< Waiters are served in arrival order. */
+            PRIORITY,   /**< Waiters are served by task priority. Tasks with the same priority are served in arrival order. */
+        };
+
+        /*! @cond  */
+        using _waitRegrantFcn_t = void (*)( void *obj );
+
+        class _waitQueue final {
+            private:
+                task *head{ nullptr };
+                task *tail{ nullptr };
+                waiterOrder order{ waiterOrder::FIFO };
+                _waitRegrantFcn_t regrant{ nullptr };
+                void *obj{ nullptr };
+                void insert( task &t ) noexcept;
+                void unlink( const task &t ) noexcept;
+                _waitQueue( _waitQueue const& ) = delete;
+                void operator=( _waitQueue const& ) = delete;
+            public:
+                _waitQueue( waiterOrder o, _waitRegrantFcn_t f, void *xObj ) noexcept : order( o ), regrant( f ), obj( xObj ) {}
+                bool pend( task &t ) noexcept;
+                task* wake( void ) noexcept;
+                bool isPending( const task &t ) const noexcept;
+                static void cancel( task &t ) noexcept;
+                static void reposition( task &t ) noexcept;
+                static void* blockedOn( const task &t, const _waitRegrantFcn_t f ) noexcept;
+                inline bool isEmpty( void ) const noexcept
+                {
+                    return ( nullptr == head );
+                }
+                inline const task* front( void ) const noexcept
+                {
+                    return head;
+                }
+                static task* running( void ) noexcept;
+        };
+        /*! @endcond  */
+
+        /**
+        * @brief A Co-Routine Semaphore.
+        * @details When used from a task, a co::semWait() that cannot take the
+        * semaphore puts the task in the waiter queue of the semaphore and stops
+        * its time events. A co::semSignal() hands the count directly to the
+        * next waiter and wakes it up with a simple notification, so waiting
+        * tasks are not polled and they are served in the order given by
+        * co::waiterOrder.
+        * @note A waiting task leaves the queue when it is removed from the
+        * scheme or its coroutine is restarted. If the count was already
+        * handed to it, the count goes to the next waiter.
+        */
         class semaphore final {
             private:
                 size_t count{ 1u };
+                _waitQueue waiters;
                 void signal( void ) noexcept;
+                static void regrant( void *obj ) noexcept;
                 bool tryLock( void ) noexcept;
                 semaphore( semaphore const& ) = delete;
                 void operator=( semaphore const& ) = delete;
@@ -96,18 +156,68 @@ namespace qOS {
                 * @see co::semWait()
                 * @see co::semSignal()
                 * @param[in] init The initial count of the semaphore.
+                * @param[in] o The order in which the waiting tasks are served.
                 */
-                explicit semaphore( size_t init ) : count( init ) {}
+                explicit semaphore( size_t init, waiterOrder o = waiterOrder::FIFO ) : count( init ), waiters( o, &regrant, this ) {}
                 /**
                 * @brief Set the coroutine semaphore with a value for the counter. Internally,
                 * the semaphores use an @c size_t to represent the counter, therefore
                 * the @a val argument should be within range of this type.
+                * @note Waiting tasks are served first from the new value.
                 * @see co::semWait()
                 * @see co::semSignal()
                 * @param[in] val The initial count of the semaphore.
                 */
                 void set( size_t val ) noexcept;
             friend class co::_coContext;
+            friend class semaphoreAwaitable;
+        };
+
+        /**
+        * @brief A Co-Routine Mutex with priority inheritance.
+        * @details Tasks that cannot take the mutex wait in priority order and
+        * are woken up by co::mutexUnlock(). While a task is waiting, the
+        * owner of the mutex inherits its priority if it is higher, so a low
+        * priority owner cannot starve a high priority waiter. The original
+        * priority of the owner is restored when it releases the mutex.
+        * If the owner is itself waiting on another mutex, it is moved to the
+        * place given by its new priority and the owner of that mutex inherits
+        * the priority too, along the whole chain of owners. Each owner gets
+        * back the priority it had when it took the mutex, so releasing the
+        * mutexes in reverse order unwinds the chain.
+        * @note A waiter that is removed from the scheme or restarted before
+        * claiming the mutex hands it to the next waiter.
+        * @note The mutex is not recursive. When several mutexes are held by
+        * the same task, they should be released in the reverse order they
+        * were taken.
+        */
+        class mutex final {
+            private:
+                task *owner{ nullptr };
+                priority_t ownerPriority{ 0u };
+                bool locked{ false };
+                _waitQueue waiters;
+                bool tryLock( void ) noexcept;
+                void unlock( void ) noexcept;
+                static void regrant( void *obj ) noexcept;
+                static void inherit( task *t, const priority_t p ) noexcept;
+                mutex( mutex const& ) = delete;
+                void operator=( mutex const& ) = delete;
+            public:
+                mutex() noexcept : waiters( waiterOrder::PRIORITY, &regrant, this ) {}
+                /**
+                * @brief Get the task that currently holds the mutex.
+                * @return A pointer to the owner task or @c nullptr if the mutex
+                * is free or it was taken outside a task context.
+                */
+                task* getOwner( void ) const noexcept;
+                /**
+                * @brief Check if the mutex is currently taken.
+                * @return @c true if the mutex is taken, otherwise returns
+                * @c false.
+                */
+                bool isLocked( void ) const noexcept;
+            friend class co::_coContext;
         };
 
         /*! @cond */
@@ -118,20 +228,41 @@ namespace qOS {
                 void operator=( _coContext const& ) = delete;
                 co::state label{ co::BEGINNING };
                 qOS::timer tm;
+                task *pending{ nullptr };
             public:
                 _coContext() = default;
                 inline void saveHandle( co::handle& h ) noexcept
                 {
                     h.ctx = this;
                 }
-                inline static void saveHandle( void ) noexcept {}
                 inline static void semSignal( semaphore& s ) noexcept
                 {
                     s.signal();
                 }
-                inline static bool semTrylock( semaphore& s ) noexcept
+                inline bool semTrylock( semaphore& s ) noexcept
+                {
+                    const bool retValue = s.tryLock();
+                    pending = retValue ? nullptr : _waitQueue::running();
+                    return retValue;
+                }
+                inline bool mutexTrylock( mutex& m ) noexcept
+                {
+                    const bool retValue = m.tryLock();
+                    pending = retValue ? nullptr : _waitQueue::running();
+                    return retValue;
+                }
+                inline void reset( void ) noexcept
+                {
+                    /*a restarted coroutine gives up any pending wait*/
+                    if ( nullptr != pending ) {
+                        _waitQueue::cancel( *pending );
+                        pending = nullptr;
+                    }
+                    label = co::BEGINNING;
+                }
+                inline static void mutexRelease( mutex& m ) noexcept
                 {
-                    return s.tryLock();
+                    m.unlock();
                 }
                 inline _coContext& operator=( co::state l )
                 {
@@ -164,6 +295,16 @@ namespace qOS {
                 {
                     return tm.expired();
                 }
+                inline static _coContext& select( _coContext &own, co::handle &h ) noexcept
+                {
+                    own.saveHandle( h );
+                    return own;
+                }
+                inline static _coContext& select( _coContext &own, _coContext &ext ) noexcept
+                {
+                    Q_UNUSED( own );
+                    return ext;
+                }
             friend class handle;
         };
         /*cstat -MISRAC++2008-0-1-11*/
@@ -171,6 +312,36 @@ namespace qOS {
         inline void crNOP( void ) noexcept {}
         /*! @endcond */
 
+        /**
+        * @brief A Co-Routine context. Holds the progress and the internal
+        * timeout of a Co-Routine segment.
+        * @details By default, co::reenter() uses a context with static storage
+        * owned by the function, so all the tasks sharing the same callback also
+        * share the same Co-Routine progress. Passing a co::context to
+        * co::reenter() allows a single callback to drive any number of
+        * independent instances. The context can live in the task storage
+        * pointer (event_t::TaskData), in a user-defined task class or in any
+        * other storage with a lifetime longer than the Co-Routine.
+        *
+        * Example:
+        * @code{.c}
+        * struct link_t {
+        *     co::context cr;
+        *     int port;
+        * };
+        * link_t link1 = { {}, 1 }, link2 = { {}, 2 };
+        *
+        * void linkTask_Callback( event_t e ) {
+        *     link_t *l = static_cast<link_t*>( e.TaskData );
+        *     co::reenter( l->cr ) {
+        *         sendRequest( l->port );
+        *         co::delay( 100_ms );
+        *     }
+        * }
+        * @endcode
+        */
+        using context = _coContext;
+
         /**
         * @brief Defines a Coroutine segment. The co::reenter() statement is used 
         * to declare the starting point of a Coroutine. It should be placed at 
@@ -203,6 +374,25 @@ namespace qOS {
         */
         inline void reenter( qOS::co::handle h ) noexcept { Q_UNUSED(h); }
 
+        /**
+        * @brief Defines a Coroutine segment that keeps its progress in the
+        * supplied context instead of the function-owned one.
+        * The co::reenter() statement is used to declare the starting point of a
+        * Coroutine. It should be placed at the start of the function in which 
+        * the Coroutine runs.
+        * @see co::context
+        * @param[in] c The context of the coroutine instance.
+        * @warning Only one segment is allowed inside a task.
+        * 
+        * Example:
+        * @code{.c}
+        * co::reenter( instance->ctx ) {
+        *
+        * }
+        * @endcode
+        */
+        inline void reenter( qOS::co::context &c ) noexcept { Q_UNUSED(c); }
+
         /**
         * @brief This statement is only allowed inside a Coroutine segment. 
         * co::yield return the CPU control back to the scheduler but saving the
@@ -289,6 +479,23 @@ namespace qOS {
         */
         inline void semSignal( co::semaphore& sem ) noexcept { Q_UNUSED(sem); }
 
+        /**
+        * @brief Takes the mutex. The Co-routine blocks while the mutex is held
+        * by another task. While blocked, the task that holds the mutex
+        * inherits the priority of the waiting task if it is higher.
+        * @see co::mutexUnlock()
+        * @param[in] m The co::mutex object in which the operation is executed
+        */
+        inline void mutexLock( co::mutex& m ) noexcept { Q_UNUSED(m); }
+
+        /**
+        * @brief Releases the mutex. The owner priority is restored and the
+        * highest priority waiting task, if any, becomes the new owner.
+        * @see co::mutexLock()
+        * @param[in] m The co::mutex object in which the operation is executed
+        */
+        inline void mutexUnlock( co::mutex& m ) noexcept { Q_UNUSED(m); }
+
         /**
         * @brief Labels the current position and saves it to @a var so it can be later
         * restored by co::setPosition()
@@ -363,7 +570,7 @@ namespace qOS {
 #define _co_label_                                  ( __LINE__ )
 
 /*============================================================================*/
-#define reenter_0()                     _co_reenter( Q_NONE )
+#define reenter_0()                     _co_reenter( _co_own_ )
 #define reenter_1(h)                    _co_reenter( h )
 #define reenter(...)                    MACRO_OVERLOAD( reenter_ , __VA_ARGS__ )
 
@@ -371,8 +578,8 @@ namespace qOS {
 // clang-format off
 #define _co_reenter( h )                                                       \
 reenter();                                                                     \
-static qOS::co::_coContext _cr;                                                \
-_cr.saveHandle( h );                                                           \
+static qOS::co::_coContext _co_own_;                                           \
+qOS::co::_coContext &_cr = qOS::co::_coContext::select( _co_own_, h );         \
 for ( ; _cr != qOS::co::SUSPENDED ; _cr = qOS::co::SUSPENDED )                 \
     if ( 0 ) {                                                                 \
         goto _co_continue_;                                                    \
@@ -443,7 +650,7 @@ _coSaveRestore( label, qOS::co::crNOP(), _co_t_cond(c) )                       \
 #define restart() _co_restart
 #define _co_restart                                                            \
 restart();                                                                     \
-_cr = qOS::co::BEGINNING;                                                      \
+_cr.reset();                                                                   \
 goto _co_break_                                                                \
 
 /*============================================================================*/
@@ -456,6 +663,16 @@ _coSaveRestore( _co_label_, qOS::co::crNOP(), _co_cond( _cr.semTrylock(sem)) ) \
 semSignal( sem );                                                              \
 _cr.semSignal( sem )                                                           \
 
+/*============================================================================*/
+#define mutexLock( m )                                                         \
+mutexLock( m );                                                                \
+_coSaveRestore( _co_label_, qOS::co::crNOP(), _co_cond( _cr.mutexTrylock(m)) ) \
+
+/*============================================================================*/
+#define mutexUnlock( m )                                                       \
+mutexUnlock( m );                                                              \
+_cr.mutexRelease( m )                                                          \
+
 /*============================================================================*/
 #define getPosition( var )   _co_get_pos( var, _co_label_ )
 #define _co_get_pos( var, label )                                              \
@@ -1,9 +1,15 @@
 #ifndef QOS_CPP_FSM
 #define QOS_CPP_FSM
 
+#include "config/config.h"
 #include "include/types.hpp"
 #include "include/timer.hpp"
 #include "include/queue.hpp"
+#include "include/list.hpp"
+
+#if ( Q_FSM_MAX_NEST_DEPTH < 2 ) || ( Q_FSM_MAX_NEST_DEPTH > 255 )
+    #error Q_FSM_MAX_NEST_DEPTH value not allowed, use a value between 2 and 255.
+#endif
 
 namespace qOS {
 
@@ -25,6 +31,7 @@ namespace qOS {
          */
 
         class state;
+        class region;
 
         /**
         * @brief The type for signal ID.
@@ -113,6 +120,16 @@ namespace qOS {
             DEEP_HISTORY,
         };
 
+        /**
+        * @brief This enumeration defines the priority levels of the signals
+        * sent to a state machine with a sm::signalQueue installed.
+        */
+        enum class signalPriority : uint8_t {
+            LOW = 0u,
+            NORMAL,
+            HIGH,
+        };
+
         #ifdef DOXYGEN
         /**
         * @brief The state callback argument to handle the state-machine dynamics and
@@ -178,6 +195,9 @@ namespace qOS {
                 bool timeoutSet( const index_t i, const qOS::duration_t t ) noexcept;
                 /**
                 * @brief Stop the time count for the selected built-in timeout.
+            * @note The signals of this timeout that are already in the
+            * signal-queue are not removed here, they are discarded when they
+            * reach the front of the queue, so this call takes constant time.
                 * @pre Requires an installed timeout-specification.
                 * For this use stateMachine::installTimeoutSpec()
                 * @pre Requires an installed signal-queue.
@@ -394,14 +414,22 @@ namespace qOS {
                 state *parent{ nullptr };
                 state *lastRunningChild{ nullptr };
                 state *initState{ nullptr };
+                state *child{ nullptr };
+                state *sibling{ nullptr };
                 stateCallback_t sCallback{ nullptr};
                 timeoutStateDefinition_t *tdef{ nullptr };
                 transition_t *tTable{ nullptr };
+                signalID *dList{ nullptr };
+                region *regions{ nullptr };
                 void *sData{ nullptr };
                 size_t tEntries{ 0u };
+                size_t dEntries{ 0u };
                 size_t nTm{ 0u };
                 _Handler *pHandler{ nullptr };
+                uint8_t depth{ 0u };
                 void sweepTransitionTable( _Handler &h ) const noexcept;
+                bool defers( const signalID s ) const noexcept;
+                void unlinkChild( sm::state *s ) noexcept;
                 state( state const& ) = delete;
                 void operator=( state const& ) = delete;
                 bool subscribe( sm::state *s, const sm::stateCallback_t sFcn, sm::state *init ) noexcept;
@@ -445,11 +473,48 @@ namespace qOS {
                 * outgoing transitions. Each entry relates signals, actions and the target
                 * state using the following layout:
                 * @verbatim { [Signal], [Action/Guard], [Target state], [History Mode] } @endverbatim
+                * @note The entries of @a table are sorted by signal at
+                * installation, so the lookup of a signal takes logarithmic time.
+                * Entries sharing the same signal keep their relative order and
+                * are still evaluated in that order. If the table is modified
+                * afterwards, it should be installed again.
                 * @param[in] n The number of elements inside @a table.
                 * @return @c true on success, otherwise return @c false.
                 */
                 bool setTransitions( transition_t *table, size_t n ) noexcept;
                 /**
+                * @brief Installs the list of signals that this state defers.
+                * @details While the state is active, the deferred signals are
+                * not dispatched. They are kept in the defer-queue of the state
+                * machine and recalled, in their original order, when the state
+                * is exited.
+                * @pre The container state-machine must have a defer-queue
+                * installed. See stateMachine::installDeferQueue()
+                * @note The entries of @a list are sorted at installation.
+                * @param[in] list An array with the signals to defer.
+                * @param[in] n The number of elements inside @a list.
+                * @return @c true on success, otherwise return @c false.
+                */
+                bool setDeferredSignals( signalID *list, size_t n ) noexcept;
+                /**
+                * @brief Attach an orthogonal region to this state.
+                * @details While this state is active, all its regions are
+                * active too, each one with its own current state. The signals
+                * reaching this state are first dispatched to every region, and
+                * only if none of them handles the signal, it is handled by
+                * this state. Entering this state also enters the regions and
+                * exiting it, exits them first.
+                * @pre The state @a init must be already added to the region.
+                * See region::add()
+                * @note A state with regions should not have child states.
+                * @note A region can only be attached to a single state.
+                * @param[in] r The region object.
+                * @param[in] init The first state of the region to be executed
+                * (default transition of the region).
+                * @return @c true on success, otherwise return @c false.
+                */
+                bool addRegion( sm::region &r, sm::state &init ) noexcept;
+                /**
                 * @brief Setup fixed timeouts for the specified state using a lookup-table.
                 * @attention This feature its only available if the FSM has a signal-queue
                 * installed.
@@ -497,7 +562,104 @@ namespace qOS {
                     return *pHandler;
                 }
             friend class qOS::stateMachine;
+            friend class region;
+        };
+
+        /**
+        * @brief A FSM orthogonal region object
+        * @details A region holds a nested hierarchy of states that runs in
+        * parallel with the other regions attached to the same state. Regions
+        * share the signal-queue, the timeout-specification and the tracer of
+        * the container state-machine, so parallel behavior does not require
+        * additional state-machines.
+        *
+        * States are added to the region with region::add() and the region is
+        * attached to its container state with state::addRegion().
+        * @note Transitions between the states of a region should stay inside
+        * the region. A transition to a state of the main hierarchy exits the
+        * container state (and all its regions) after the signal is dispatched
+        * to the region. A transition to a state of another region is
+        * ignored and the handler status becomes sm::status::FAILURE.
+        */
+        class region {
+            private:
+                state root;
+                state *current{ nullptr };
+                state *owner{ nullptr };
+                region *next{ nullptr };
+                region( region const& ) = delete;
+                void operator=( region const& ) = delete;
+            public:
+                region() = default;
+                /**
+                * @brief Add the specified state to the region
+                * @param[in] s The state object.
+                * @param[in] sFcn The handler function associated to the state.
+                *
+                * Prototype: @code sm::status xCallback( sm::handler_t h ) @endcode
+                * @param[in] init The first child-state to be executed if the subscribed
+                * state its a parent in an hierarchical pattern. (default transition).
+                * @return @c true on success, otherwise return @c false.
+                */
+                inline bool add( sm::state &s, sm::stateCallback_t sFcn, sm::state &init ) noexcept
+                {
+                    return root.subscribe( &s, sFcn, &init );
+                }
+                /**
+                * @brief Add the specified state to the region
+                * @param[in] s The state object.
+                * @param[in] sFcn The handler function associated to the state.
+                *
+                * Prototype: @code sm::status xCallback( sm::handler_t h ) @endcode
+                * @return @c true on success, otherwise return @c false.
+                */
+                inline bool add( sm::state &s, sm::stateCallback_t sFcn ) noexcept
+                {
+                    return root.subscribe( &s, sFcn, nullptr );
+                }
+                /**
+                * @brief Get the current state of the region
+                * @return A pointer to the current state of the region or
+                * @c nullptr if the region is not active.
+                */
+                inline const sm::state* getCurrent( void ) const noexcept
+                {
+                    return current;
+                }
+            friend class state;
+            friend class qOS::stateMachine;
+        };
+
+        class timeoutWheel;
+        class tracer;
+        class signalQueue;
+        class signalWaiter;
+
+        /*! @cond  */
+        class timeoutEntry : protected node {
+            private:
+                stateMachine *machine{ nullptr };
+                index_t index{ 0u };
+                timeoutEntry( timeoutEntry const& ) = delete;
+                void operator=( timeoutEntry const& ) = delete;
+            public:
+                timeoutEntry() = default;
+            friend class timeoutWheel;
+            friend class qOS::stateMachine;
+        };
+
+        using signalWaiterFcn_t = bool (*)( signalWaiter &w, const signal_t &sig );
+
+        class signalWaiter : protected node {
+            private:
+                signalWaiterFcn_t notifyFcn{ nullptr };
+                signalWaiter( signalWaiter const& ) = delete;
+                void operator=( signalWaiter const& ) = delete;
+            protected:
+                explicit signalWaiter( const signalWaiterFcn_t f ) noexcept : notifyFcn( f ) {}
+            friend class qOS::stateMachine;
         };
+        /*! @endcond  */
 
         /**
         * @brief A FSM Timeout-specification object
@@ -506,7 +668,12 @@ namespace qOS {
         class timeoutSpec {
             uint32_t isPeriodic{ 0u };
             timer timeout[ Q_FSM_MAX_TIMEOUTS ];
+            size_t pending[ Q_FSM_MAX_TIMEOUTS ] = { 0u };
+            size_t cancelled[ Q_FSM_MAX_TIMEOUTS ] = { 0u };
+            timeoutEntry entry[ Q_FSM_MAX_TIMEOUTS ];
+            timeoutWheel *wheel{ nullptr };
             friend class qOS::stateMachine;
+            friend class timeoutWheel;
         };
 
         /*! @cond  */
@@ -589,14 +756,28 @@ namespace qOS {
             sm::state *current{ nullptr };
             sm::state *next{ nullptr };
             sm::state *source{ nullptr };
+            const sm::state *scope{ nullptr };
+            sm::state *escTarget{ nullptr };
+            sm::historyMode escHistory{ sm::historyMode::NO_HISTORY };
             queue *sQueue{ nullptr };
+            sm::signalQueue *pQueue{ nullptr };
+            queue *dQueue{ nullptr };
+            size_t recallCount{ 0u };
+            size_t nDeferred{ 0u };
             sm::timeoutSpec *timeSpec{ nullptr };
             sm::surroundingCallback_t surrounding{ nullptr };
             sm::state top;
             sm::signal_t signalNot;
             void *owner{ nullptr };
             void *mData{ nullptr };
-            bool internalSignalSend( sm::signalID sig, void *sData, bool isUrgent ) noexcept;
+            sm::tracer *xTracer{ nullptr };
+            list waiters;
+            void (*xNotifyFcn)( stateMachine *arg ) = { nullptr };
+            size_t drainLimit{ 1u };
+            qOS::duration_t drainBudget{ 0u };
+            bool compiled{ false };
+            bool internalSignalSend( sm::signalID sig, void *sData, bool isUrgent, const sm::signalPriority p ) noexcept;
+            bool deferSignal( const sm::signal_t &sig ) noexcept;
             void timeoutCheckSignals( void ) noexcept;
             void timeoutPerformSpecifiedActions( sm::state * const s, sm::signalID sig ) noexcept;
             void transition( sm::state *target, sm::historyMode mHistory ) noexcept;
@@ -611,6 +792,26 @@ namespace qOS {
             void tracePathAndRetraceEntry( sm::state **trace ) noexcept;
             void traceOnStart( sm::state **entryPath ) noexcept;
             sm::signal_t checkForSignals( sm::signal_t sig ) noexcept;
+            size_t pendingSignals( void ) noexcept;
+            bool timeoutCancelled( const sm::signalID id ) const noexcept;
+            bool takeQueued( sm::signal_t *dst ) noexcept;
+            const sm::signal_t* frontQueued( void ) const noexcept;
+            size_t countQueued( void ) const noexcept;
+            bool timeoutDiscard( const sm::signalID id ) noexcept;
+            void timeoutResync( void ) noexcept;
+            bool timeoutArm( const index_t i, const qOS::duration_t t ) noexcept;
+            void timeoutDisarm( const index_t i ) noexcept;
+            bool timeoutExpired( const index_t i ) noexcept;
+            bool inScope( const sm::state *s ) const noexcept;
+            static bool descends( const sm::state *s, const sm::state * const ancestor ) noexcept;
+            static bool compileTree( sm::state * const root ) noexcept;
+            bool propagate( sm::signal_t sig, sm::state **entryPath ) noexcept;
+            bool dispatchRegions( sm::state * const s, sm::signal_t sig, sm::state **entryPath ) noexcept;
+            void enterRegions( const sm::state * const s ) noexcept;
+            void exitRegions( const sm::state * const s ) noexcept;
+            void traceActive( const sm::state * const from, const sm::state * const stop, const bool entered ) noexcept;
+            void notifyWaiters( const sm::signal_t &sig ) noexcept;
+            bool dispatch( sm::signal_t sig ) noexcept;
             stateMachine( stateMachine const& ) = delete;
             void operator=( stateMachine const& ) = delete;
             bool smSetup( sm::stateCallback_t topFcn, sm::state *init, const sm::surroundingCallback_t sFcn, void* pData ) noexcept;
@@ -640,6 +841,24 @@ namespace qOS {
                 return smSetup( topFcn, &init, sFcn, pData );
             }
             /**
+            * @brief Precompute the nesting depth of every state of the
+            * hierarchy, so the least common ancestor (LCA) of a transition is
+            * found by walking the parent links once, in time proportional to
+            * the nesting depth.
+            * @details The states inside the regions are included, a region
+            * starts at the depth of its container state. The nesting depth is
+            * also checked against @c Q_FSM_MAX_NEST_DEPTH, so a topology that would overflow the
+            * entry path of a transition is reported here instead of failing at
+            * runtime. Without this call, the LCA is found with the default
+            * search, which is quadratic in the nesting depth.
+            * @pre Should be called after all the states have been added.
+            * @note If the topology is changed afterwards, this method should
+            * be called again.
+            * @return @c true on success, @c false if the nesting depth exceeds
+            * @c Q_FSM_MAX_NEST_DEPTH
+            */
+            bool compile( void ) noexcept;
+            /**
             * @brief Add the specified state to the stateMachine "Top" state
             * @param[in] s The state object.
             * @param[in] sFcn The handler function associated to the state.
@@ -672,11 +891,43 @@ namespace qOS {
             * @pre Queue object should be previously initialized by using
             * queue::setup()
             * @attention Queue item size = sizeof( @ref sm::signal_t )
+            * @note The signals of the queue are owned by the FSM. Timeout
+            * signals taken out of the queue by other means (a reset or a
+            * direct receive) are only accounted again once the queue is
+            * found empty.
             * @param[in] q The queue to be installed.
             * @return @c true on success, otherwise return @c false.
             */
             bool installSignalQueue( queue& q ) noexcept;
             /**
+            * @brief Install a priority signal queue to the provided Finite
+            * State Machine (FSM). Signals are taken from the highest priority
+            * level that is not empty. It replaces the regular signal queue, if
+            * any.
+            * @pre The queue should be previously initialized by using
+            * sm::signalQueue::setup()
+            * @see sm::signalQueue, stateMachine::sendSignal( sm::signalID, void*, const sm::signalPriority )
+            * @param[in] q The priority signal queue to be installed.
+            * @return @c true on success, otherwise return @c false.
+            */
+            bool installSignalQueue( sm::signalQueue& q ) noexcept;
+            /**
+            * @brief Install the queue that holds the signals deferred by the
+            * states of the FSM.
+            * @details A signal is deferred when any of the active states lists
+            * it with sm::state::setDeferredSignals(). When a state with
+            * deferred signals is exited, the signals waiting in the
+            * defer-queue are recalled: they are dispatched before the signals
+            * of the signal-queue, in the order they arrived. Recalled signals
+            * that are still deferred go back to the defer-queue.
+            * @note If the defer-queue is full, the signal is dispatched as
+            * usual.
+            * @attention Queue item size = sizeof( @ref sm::signal_t )
+            * @param[in] q The queue to be installed.
+            * @return @c true on success, otherwise return @c false.
+            */
+            bool installDeferQueue( queue& q ) noexcept;
+            /**
             * @brief Sends a signal to a state machine 
             * @note If the signal queue is not available, an exclusion variable will be
             * used.This means that the signal cannot be sent until the variable is empty.
@@ -693,10 +944,27 @@ namespace qOS {
             * queue. (only if the there is a signal-queue available)
             * @return @c true if the provided signal was successfully delivered to the
             * state machine , otherwise return @c false. @c false if there is a queue,
-            * and the signal cannot be inserted because it is full.
+            * and the signal cannot be inserted because it is full. Timeout
+            * signals are reserved to the engine and are always rejected.
             */
             bool sendSignal( sm::signalID sig, void *sData = nullptr, bool isUrgent = false ) noexcept;
             /**
+            * @brief Sends a signal to a state machine with the given priority.
+            * @note With a sm::signalQueue installed, the signal is put at the
+            * back of the level @a p. With a regular queue, only
+            * sm::signalPriority::HIGH signals are sent to the front. Without a
+            * queue, the exclusion variable is used.
+            * @warning Data associated to the signal is not deep-copied. See
+            * stateMachine::sendSignal()
+            * @param[in] sig The user-defined signal.
+            * @param[in] sData The data associated to the signal.
+            * @param[in] p The priority of the signal.
+            * @return @c true if the provided signal was successfully delivered to the
+            * state machine , otherwise return @c false. Timeout signals are
+            * always rejected.
+            */
+            bool sendSignal( sm::signalID sig, void *sData, const sm::signalPriority p ) noexcept;
+            /**
             * @brief Install the Timeout-specification object to target FSM to allow
             * timed signals within states.
             * @attention This feature its only available if the FSM has a signal-queue
@@ -711,6 +979,19 @@ namespace qOS {
             */
             bool installTimeoutSpec( sm::timeoutSpec &ts ) noexcept;
             /**
+            * @brief Install the Timeout-specification object to target FSM and
+            * register its timeouts in a shared sm::timeoutWheel.
+            * @details The armed timeouts are scheduled in the wheel, so the
+            * FSM does not poll its timers on every run. When a timeout
+            * expires, the wheel puts the sm::SIGNAL_TIMEOUT() signal directly
+            * on the FSM and wakes the task that runs it.
+            * @see stateMachine::installSignalQueue(), sm::timeoutWheel
+            * @param[in] ts The timeout specification object.
+            * @param[in] w The timeout wheel shared by many state machines.
+            * @return Returns @c true on success, otherwise returns @c false.
+            */
+            bool installTimeoutSpec( sm::timeoutSpec &ts, sm::timeoutWheel &w ) noexcept;
+            /**
             * @brief Set the time for the selected built-in timeout inside the target FSM.
             * @pre Requires an installed timeout-specification.
             * For this use stateMachine::installTimeoutSpec()
@@ -746,7 +1027,8 @@ namespace qOS {
             /**
             * @brief Get a pointer to the installed queue if available
             * @return A pointer to the installed queue if available, 
-            * otherwise returns @c nullptr.
+            * otherwise returns @c nullptr. A sm::signalQueue is not reported
+            * here.
             */
             queue * const & getQueue( void ) const noexcept;
             /**
@@ -761,6 +1043,15 @@ namespace qOS {
             */
             void * const & getData( void ) const noexcept;
             /**
+            * @brief Retrieves a pointer of the owner of this object, i.e. the
+            * task added with core::addStateMachineTask()
+            * @return @c A pointer to the owner.
+            */
+            inline void* getOwner( void ) const noexcept
+            {
+                return owner;
+            }
+            /**
             * @brief Set the state-machine surrounding callback
             * @param[in] sFcn The surrounding callback function.
             */
@@ -772,11 +1063,74 @@ namespace qOS {
             * installed queue has items available)
             * @note A signal coming from the signal-queue has the higher precedence.
             * The user-defined signal can be overridden
+            * @note When a drain mode is set with stateMachine::setDrainMode(),
+            * additional pending signals are processed in the same call.
             * @return @c true if the signal was successfully handled, otherwise returns
-            * @c false.
+            * @c false. In drain mode, @c true if any of the processed signals
+            * was handled.
             */
             bool run( sm::signal_t sig ) noexcept;
+            /**
+            * @brief Set how many pending signals are processed on every
+            * stateMachine::run() call.
+            * @details By default, a single signal is processed on every call,
+            * so a burst of signals takes as many activations of the FSM task as
+            * signals are queued. In drain mode, after processing the first
+            * signal, the FSM keeps taking signals from the signal-queue (or the
+            * exclusion variable) until there are no more signals, @a maxSignals
+            * signals have been processed or the time budget expires.
+            * Every signal is still processed with run-to-completion semantics.
+            * Timeout signals discarded by stateMachine::timeoutStop() are not
+            * counted as pending signals.
+            * @param[in] maxSignals The maximum number of signals processed by
+            * a single call. Use @c 0 to process the signals that were pending
+            * when the call started and @c 1 to restore the default behavior.
+            * @note With @c 0, signals posted by the handlers during the call
+            * are left for the next activation, so a handler that posts a
+            * signal on every dispatch cannot keep the FSM task running
+            * forever.
+            * @param[in] budget The maximum amount of time that a single call can
+            * spend processing signals. The check is performed between signals,
+            * so a signal is never interrupted. Use clock::NONE (default) to
+            * disable the time budget.
+            */
+            void setDrainMode( const size_t maxSignals, const qOS::duration_t budget = clock::NONE ) noexcept;
+            /**
+            * @brief Install an execution tracer in the state machine.
+            * @details The tracer records the dispatched signals, the guard
+            * evaluations, the transitions and the status of the states, and
+            * keeps the residency and transition profiles. The active states
+            * are considered entered at the moment of the installation.
+            * @see sm::tracer
+            * @param[in] t The tracer object.
+            * @return Returns @c true on success, otherwise returns @c false.
+            */
+            bool installTracer( sm::tracer &t ) noexcept;
+            /**
+            * @brief Remove the execution tracer from the state machine. The
+            * records and profiles are kept in the tracer.
+            */
+            void removeTracer( void ) noexcept;
+            /**
+            * @brief Attach a waiter that is notified at the end of every
+            * dispatch, once the signal has been handled. The waiter is
+            * detached when its notification function returns @c true.
+            * @note This is the hook used by the co::signal() and
+            * co::inState() awaitables, so they are woken by the dispatch
+            * instead of polling the state machine.
+            * @param[in] w The waiter object.
+            * @return @c true on success, otherwise return @c false.
+            */
+            bool attachWaiter( sm::signalWaiter &w ) noexcept;
+            /**
+            * @brief Detach a waiter from the state machine.
+            * @param[in] w The waiter object.
+            * @return @c true on success, otherwise return @c false.
+            */
+            bool detachWaiter( sm::signalWaiter &w ) noexcept;
         friend class core;
+        friend class sm::timeoutWheel;
+        friend class sm::state;
     };
     /** @}*/
     namespace sm {
@@ -790,6 +1144,7 @@ namespace qOS {
         * @details This object provides a mechanism to decouple signal producers
         * from the signal consumers, so state-machine objects interested in 
         * certain signals subscribe to one or more Signals".
+        * @see sm::signalBroker for a broker without a fixed capacity.
         */
         class signalPublisher {
             private:
@@ -838,6 +1193,474 @@ namespace qOS {
                 */
                 bool sendSignal( sm::signalID sig, void *sData = nullptr, bool isUrgent = false ) noexcept;
         };
+
+        class signalBroker;
+
+        /**
+        * @brief A subscription of a state machine to a signal of a
+        * sm::signalBroker
+        * @details The subscription is the node that links the state machine
+        * to the broker, so the storage of every subscription is supplied by
+        * the subscriber and the broker does not need any fixed capacity. It
+        * also keeps the status of the last delivery and the number of failed
+        * deliveries.
+        */
+        class subscription : protected node {
+            private:
+                stateMachine *machine{ nullptr };
+                signalID sig{ signalID::SIGNAL_NONE };
+                uint32_t mask{ 0xFFFFFFFFuL };
+                size_t failures{ 0u };
+                bool lastDelivered{ false };
+                subscription( subscription const& ) = delete;
+                void operator=( subscription const& ) = delete;
+            public:
+                subscription() = default;
+                /**
+                * @brief Check if the subscription is linked to a broker.
+                * @return @c true if the subscription is active, otherwise
+                * returns @c false.
+                */
+                inline bool isActive( void ) const noexcept
+                {
+                    return ( nullptr != getContainer() );
+                }
+                /**
+                * @brief Get the status of the last delivery to the subscriber.
+                * @return @c true if the last published signal matching this
+                * subscription was delivered, otherwise returns @c false.
+                */
+                inline bool delivered( void ) const noexcept
+                {
+                    return lastDelivered;
+                }
+                /**
+                * @brief Get the number of signals that could not be delivered
+                * to the subscriber, e.g. because its signal-queue was full.
+                * @return The number of failed deliveries.
+                */
+                inline size_t getFailures( void ) const noexcept
+                {
+                    return failures;
+                }
+            friend class signalBroker;
+        };
+
+        /**
+        * @brief A publish/subscribe broker for the signals of many state
+        * machines.
+        * @details Unlike sm::signalPublisher, the broker does not have a fixed
+        * capacity. Subscriptions are linked in lists, indexed by a hash of the
+        * signal, using sm::subscription objects supplied by the subscribers.
+        * Publishing a signal only visits the subscriptions sharing its hash
+        * bucket, and unsubscribing takes constant time. A subscription can
+        * also use a wildcard mask to receive a group of signals.
+        *
+        * Example:
+        * @code{.c}
+        * static list topics[ 32 ];
+        * sm::signalBroker broker;
+        * sm::subscription sub1, sub2;
+        *
+        * broker.setup( topics, 32u );
+        * broker.subscribe( sub1, motorFSM, SIG_STOP );
+        * broker.subscribe( sub2, loggerFSM, sm::SIGNAL_USER( 0x100u ), 0xFFFFFF00uL ); // 0x100-0x1FF
+        * broker.publish( SIG_STOP );
+        * @endcode
+        */
+        class signalBroker {
+            private:
+                list *buckets{ nullptr };
+                size_t nBuckets{ 0u };
+                list wildcards;
+                signalBroker( signalBroker const& ) = delete;
+                void operator=( signalBroker const& ) = delete;
+                size_t deliver( list &l, const signalID s, void *sData, const bool isUrgent ) noexcept;
+                bool owns( const subscription &sub ) const noexcept;
+            public:
+                signalBroker() = default;
+                /**
+                * @brief Initializes the broker.
+                * @param[in] table An array of lists used as hash buckets for the
+                * subscriptions.
+                * @param[in] n The number of elements inside @a table. Should be
+                * a power of two.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setup( list *table, const size_t n ) noexcept;
+                /**
+                * @brief Subscribe a state machine to a signal. If @a sub is
+                * already in use, it is moved to the new signal.
+                * @param[in] sub The subscription object. Should stay alive while
+                * the subscription is active.
+                * @param[in] m The subscriber state machine.
+                * @param[in] s The user-defined signal.
+                * @param[in] mask The wildcard mask. A published signal @c x
+                * matches the subscription if <tt>( x & mask ) == ( s & mask )</tt>.
+                * The default value only matches @a s.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool subscribe( subscription &sub, stateMachine &m, const signalID s, const uint32_t mask = 0xFFFFFFFFuL ) noexcept;
+                /**
+                * @brief Cancel a subscription.
+                * @param[in] sub The subscription object.
+                * @return @c true on success, @c false if @a sub does not belong
+                * to this broker.
+                */
+                bool unsubscribe( subscription &sub ) noexcept;
+                /**
+                * @brief Sends a signal to all the matching subscribers.
+                * @note The result of the delivery to every subscriber is kept in
+                * its subscription, see sm::subscription::delivered()
+                * @warning Data associated to the signal is not deep-copied. See
+                * stateMachine::sendSignal()
+                * @param[in] s The user-defined signal.
+                * @param[in] sData The data associated to the signal.
+                * @param[in] isUrgent If true, the signal will be sent to the front
+                * of the signal-queue of every subscriber.
+                * @return The number of subscribers that received the signal.
+                */
+                size_t publish( const signalID s, void *sData = nullptr, const bool isUrgent = false ) noexcept;
+        };
+
+        /**
+        * @brief A timing wheel that drives the timeouts of many state
+        * machines.
+        * @details State machines that install their timeout-specification
+        * with stateMachine::installTimeoutSpec( sm::timeoutSpec&, sm::timeoutWheel& )
+        * register every armed timeout in the wheel instead of polling their
+        * timers on every run. The wheel hashes the timeouts by their
+        * expiration tick into a table of lists, so arming and stopping a
+        * timeout takes constant time and timeoutWheel::service() only visits
+        * the slots of the ticks elapsed since the previous call. When a
+        * timeout expires, its signal is put on the state machine and its task
+        * is woken, so idle state machines do not consume CPU time.
+        *
+        * Example:
+        * @code{.c}
+        * static list slots[ 64 ];
+        * sm::timeoutWheel wheel;
+        *
+        * void wheelTask_Callback( event_t e ) {
+        *     (void)e;
+        *     wheel.service();
+        * }
+        *
+        * wheel.setup( slots, 64u );
+        * motorFSM.installTimeoutSpec( motorTimeouts, wheel );
+        * os.addTask( wheelTask, wheelTask_Callback, core::HIGHEST_PRIORITY, 1_ms, task::PERIODIC );
+        * os.addStateMachineTask( motorTask, motorFSM, core::MEDIUM_PRIORITY, 1_sec );
+        * @endcode
+        * @note A task attached to the signal-queue of the state machine by
+        * core::addStateMachineTask() is triggered by the queue, otherwise it
+        * is notified.
+        */
+        class timeoutWheel {
+            private:
+                list *slots{ nullptr };
+                size_t nSlots{ 0u };
+                qOS::clock_t lastTick{ 0u };
+                timeoutWheel( timeoutWheel const& ) = delete;
+                void operator=( timeoutWheel const& ) = delete;
+                void schedule( timeoutEntry &e, const timer &t ) noexcept;
+                static void cancel( timeoutEntry &e ) noexcept;
+            public:
+                timeoutWheel() = default;
+                /**
+                * @brief Initializes the timeout wheel.
+                * @param[in] table An array of lists used as the slots of the
+                * wheel. Each slot holds the timeouts expiring at the same tick
+                * modulo @a n.
+                * @param[in] n The number of elements inside @a table. Should be
+                * a power of two.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setup( list *table, const size_t n ) noexcept;
+                /**
+                * @brief Deliver the signals of all the expired timeouts.
+                * @note Should be called periodically, for example from a task
+                * running at the resolution required by the timeouts.
+                * @return The number of timeout signals delivered.
+                */
+                size_t service( void ) noexcept;
+            friend class qOS::stateMachine;
+        };
+
+        /**
+        * @brief The kind of event stored in a sm::traceRecord
+        */
+        enum class traceEvent : uint8_t {
+            SIGNAL = 0u,        /**< A signal was dispatched to the state machine*/
+            GUARD,              /**< A guard of the transition table was evaluated*/
+            TRANSITION,         /**< A transition was taken*/
+            STATUS,             /**< A state handled the signal and returned a status*/
+        };
+
+        /**
+        * @brief A fixed-size record of the execution trace of a state machine.
+        * @details The meaning of the fields depends on the event:
+        * - traceEvent::SIGNAL : @a source is the current state.
+        * - traceEvent::GUARD : @a source is the state owning the transition
+        * table, @a target the target of the entry and @a guard the result.
+        * - traceEvent::TRANSITION : @a source is the state handling the
+        * signal, @a target the target state and @a history the history mode.
+        * - traceEvent::STATUS : @a source is the state and @a result the
+        * value returned by its callback.
+        */
+        struct traceRecord {
+            qOS::clock_t tick{ 0u };                            /**< The epoch of the event*/
+            const state *source{ nullptr };                     /**< The source state*/
+            const state *target{ nullptr };                     /**< The target state*/
+            signalID sig{ signalID::SIGNAL_NONE };              /**< The signal being dispatched*/
+            status result{ status::ABSENT };                    /**< The status of the state callback*/
+            traceEvent event{ traceEvent::SIGNAL };             /**< The kind of event*/
+            historyMode history{ historyMode::NO_HISTORY };     /**< The history mode of the transition*/
+            bool guard{ false };                                /**< The result of the guard*/
+        };
+
+        /**
+        * @brief The residency profile of a state, used by sm::tracer
+        */
+        struct stateProfile {
+            const state *s{ nullptr };          /**< The profiled state*/
+            qOS::clock_t residency{ 0u };       /**< The accumulated time inside the state*/
+            qOS::clock_t enteredAt{ 0u };       /**< The epoch of the last entry*/
+            size_t entries{ 0u };               /**< The number of times the state was entered*/
+            bool active{ false };               /**< The state is currently active*/
+        };
+
+        /**
+        * @brief The counter of a transition, used by sm::tracer
+        */
+        struct transitionProfile {
+            const state *source{ nullptr };     /**< The state that handled the signal*/
+            const state *target{ nullptr };     /**< The target state*/
+            size_t count{ 0u };                 /**< The number of times the transition was taken*/
+        };
+
+        /**
+        * @brief An execution tracer for state machines.
+        * @details Once installed with stateMachine::installTracer(), the
+        * tracer records every dispatched signal, guard evaluation, transition
+        * and state status into a ring of sm::traceRecord entries. When the
+        * ring is full, the oldest records are overwritten and counted as lost.
+        * Optionally, the tracer also accumulates the time spent inside every
+        * state and the number of times every transition is taken, using the
+        * profile tables supplied with tracer::setProfiling(). The tables are
+        * filled as new states and transitions are found. Their slots are
+        * selected by hashing the state addresses, so the lookup done on
+        * every transition does not depend on the size of the tables and the
+        * entries are not stored in order of appearance.
+        *
+        * Example:
+        * @code{.c}
+        * static sm::traceRecord records[ 128 ];
+        * static sm::stateProfile stateStats[ 8 ];
+        * static sm::transitionProfile transitionStats[ 16 ];
+        * sm::tracer trace;
+        *
+        * trace.setup( records, 128u );
+        * trace.setProfiling( stateStats, 8u, transitionStats, 16u );
+        * motorFSM.installTracer( trace );
+        * @endcode
+        * @note A tracer should be installed in a single state machine.
+        */
+        class tracer {
+            private:
+                traceRecord *ring{ nullptr };
+                size_t ringSize{ 0u };
+                size_t head{ 0u };
+                size_t items{ 0u };
+                size_t nLost{ 0u };
+                stateProfile *sProfiles{ nullptr };
+                size_t nStates{ 0u };
+                transitionProfile *tProfiles{ nullptr };
+                size_t nTransitions{ 0u };
+                tracer( tracer const& ) = delete;
+                void operator=( tracer const& ) = delete;
+                void record( traceRecord r ) noexcept;
+                size_t stateSlot( const state * const s ) const noexcept;
+                size_t transitionSlot( const state * const src, const state * const dst ) const noexcept;
+                stateProfile* profileOf( const state * const s, const bool claim ) noexcept;
+                transitionProfile* profileOf( const state * const src, const state * const dst, const bool claim ) noexcept;
+                void stateEntered( const state * const s ) noexcept;
+                void stateExited( const state * const s ) noexcept;
+                void transitionTaken( const state * const src, const state * const dst ) noexcept;
+            public:
+                tracer() = default;
+                /**
+                * @brief Initializes the ring of trace records.
+                * @param[in] buffer An array of sm::traceRecord to store the
+                * records.
+                * @param[in] n The number of elements inside @a buffer.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setup( traceRecord *buffer, const size_t n ) noexcept;
+                /**
+                * @brief Enable the state-residency and transition profiling.
+                * @param[in] sp An array of sm::stateProfile, one for every
+                * state to profile. Can be @c nullptr.
+                * @param[in] nS The number of elements inside @a sp.
+                * @param[in] tp An array of sm::transitionProfile, one for every
+                * transition to profile. Can be @c nullptr.
+                * @param[in] nT The number of elements inside @a tp.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setProfiling( stateProfile *sp, const size_t nS, transitionProfile *tp, const size_t nT ) noexcept;
+                /**
+                * @brief Retrieve and remove the oldest records of the ring.
+                * @param[out] dst The array where the records will be copied.
+                * @param[in] n The maximum number of records to retrieve.
+                * @return The number of records copied to @a dst.
+                */
+                size_t read( traceRecord *dst, const size_t n ) noexcept;
+                /**
+                * @brief Get the number of records waiting in the ring.
+                * @return The number of records available to read.
+                */
+                size_t count( void ) const noexcept;
+                /**
+                * @brief Get the number of records overwritten before they were
+                * read.
+                * @return The number of lost records.
+                */
+                size_t lost( void ) const noexcept;
+                /**
+                * @brief Get the accumulated time spent inside a state,
+                * including the current stay if the state is active.
+                * @param[in] s The state.
+                * @return The residency time in epochs. Zero if the state is
+                * not profiled.
+                */
+                qOS::clock_t getResidency( const state &s ) const noexcept;
+                /**
+                * @brief Get the number of times a state was entered.
+                * @param[in] s The state.
+                * @return The number of entries. Zero if the state is not
+                * profiled.
+                */
+                size_t getEntries( const state &s ) const noexcept;
+                /**
+                * @brief Get the number of times a transition was taken.
+                * @param[in] src The state that handled the signal.
+                * @param[in] dst The target state.
+                * @return The number of times the transition was taken. Zero if
+                * the transition is not profiled.
+                */
+                size_t getTransitionCount( const state &src, const state &dst ) const noexcept;
+                /**
+                * @brief Discard all the records and reset the profiles.
+                */
+                void clear( void ) noexcept;
+            friend class qOS::stateMachine;
+            friend class state;
+        };
+
+        /**
+        * @brief A signal queue with three priority levels.
+        * @details The storage is divided between the sm::signalPriority
+        * levels and every level is a FIFO. Receiving a signal takes it from
+        * the highest level that is not empty, so urgent signals are not
+        * delayed by a burst of less important ones, and the order of the
+        * signals with the same priority is kept. It can be installed in a
+        * state machine with stateMachine::installSignalQueue() instead of a
+        * regular qOS::queue.
+        *
+        * Example:
+        * @code{.c}
+        * static sm::signal_t storage[ 24 ];
+        * sm::signalQueue sigQueue;
+        *
+        * sigQueue.setup( storage, 24u ); // 8 signals per level
+        * motorFSM.installSignalQueue( sigQueue );
+        * motorFSM.sendSignal( SIG_FAULT, nullptr, sm::signalPriority::HIGH );
+        * motorFSM.sendSignal( SIG_TICK ); // sm::signalPriority::NORMAL
+        * @endcode
+        * @note This is not a qOS::queue, so it cannot be attached to a task.
+        * The task of the state machine is notified by the engine every time
+        * a signal is posted.
+        */
+        class signalQueue final {
+            private:
+                static const size_t LEVELS = 3u;
+                queue lanes[ LEVELS ];
+                signalQueue( signalQueue const& ) = delete;
+                void operator=( signalQueue const& ) = delete;
+                queue* front( void ) const noexcept;
+            public:
+                signalQueue() = default;
+                /**
+                * @brief Initializes the priority signal queue.
+                * @param[in] storage An array of sm::signal_t used to hold the
+                * signals.
+                * @param[in] n The number of elements inside @a storage. Every
+                * priority level gets @c n/3 elements.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setup( signal_t *storage, const size_t n ) noexcept;
+                /**
+                * @brief Post a signal to the back of the given priority level.
+                * @param[in] sig The signal.
+                * @param[in] p The priority level.
+                * @param[in] isUrgent If true, the signal is put at the front of
+                * its level.
+                * @return @c true on success, @c false if the level is full.
+                */
+                bool post( const signal_t &sig, const signalPriority p, const bool isUrgent = false ) noexcept;
+                /**
+                * @brief Take the signal of the highest priority level that is
+                * not empty.
+                * @param[out] dst Where the signal will be copied.
+                * @return @c true if a signal was received, otherwise returns
+                * @c false.
+                */
+                bool receive( signal_t *dst ) noexcept;
+                /**
+                * @brief Look at the signal that would be received next,
+                * without removing it.
+                * @return A pointer to the signal, or @c nullptr if the queue is
+                * empty.
+                */
+                const signal_t* peek( void ) const noexcept;
+                /**
+                * @brief Remove the signal that would be received next.
+                * @return @c true on success, @c false if the queue is empty.
+                */
+                bool removeFront( void ) noexcept;
+                /**
+                * @brief Discard all the signals of every priority level.
+                */
+                void reset( void ) noexcept;
+                /**
+                * @brief Get the number of signals in all the priority levels.
+                * @return The number of signals waiting.
+                */
+                size_t count( void ) const noexcept;
+                /**
+                * @brief Returns the empty status of the queue.
+                * @return @c true if all the priority levels are empty,
+                * otherwise returns @c false.
+                */
+                bool isEmpty( void ) const noexcept;
+                /**
+                * @brief Returns the full status of the queue.
+                * @return @c true if all the priority levels are full,
+                * otherwise returns @c false.
+                */
+                bool isFull( void ) const noexcept;
+                /**
+                * @brief Get the number of free slots in all the priority
+                * levels.
+                * @return The number of signals that can still be posted.
+                */
+                size_t itemsAvailable( void ) const noexcept;
+                /**
+                * @brief Check if the queue has been initialized with
+                * signalQueue::setup().
+                * @return @c true if initialized, otherwise returns @c false.
+                */
+                bool isInitialized( void ) const noexcept;
+        };
         /** @}*/
     }
 
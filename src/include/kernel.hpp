@@ -7,6 +7,7 @@
 #include "include/types.hpp"
 #include "include/task.hpp"
 #include "include/prioqueue.hpp"
+#include "include/memory.hpp"
 
 #if ( Q_FSM == 1 )
     #include "include/fsm.hpp"
@@ -89,6 +90,7 @@ namespace qOS {
             volatile coreFlags_t flag{ 0uL };
             notificationSpreader_t nSpreader{ notifyMode::_NONE_, nullptr };
             size_t taskEntries{ 0uL };
+            mem::arena *arenas{ nullptr };
             list coreLists[ Q_PRIORITY_LEVELS + 2 ];
             list& waitingList;  // skipcq: CXX-W2012
             list& suspendedList;  // skipcq: CXX-W2012
@@ -102,6 +104,7 @@ namespace qOS {
             void dispatchTaskFillEventInfo( task *Task ) noexcept;
             void dispatch( list * const xList ) noexcept;
             void dispatchIdle( void ) noexcept;
+            void resetArenas( void ) noexcept;
             core() : waitingList( coreLists[ Q_PRIORITY_LEVELS ] ), suspendedList( coreLists[ Q_PRIORITY_LEVELS + 1 ] ) {}
             core( core &other ) = delete;
             void operator=( const core & ) = delete;
@@ -407,6 +410,13 @@ namespace qOS {
             */
             task* getTaskByID( size_t id ) noexcept;
             /**
+            * @brief Retrieve the task currently being executed.
+            * @note The idle task is never reported.
+            * @return A pointer to the running task or @c nullptr if called
+            * outside the context of a task.
+            */
+            task* getTaskRunning( void ) const noexcept;
+            /**
             * @brief Yield the control of the current running task to another task.
             * @note This API can only be invoked from the context of a task.
             * @note Target task will inherit the event data.
@@ -417,6 +427,24 @@ namespace qOS {
             */
             bool yieldToTask( task &Task ) noexcept;
             /**
+            * @brief Bind an arena to the scheduling cycle. The kernel resets the
+            * arena after every task activation (including the idle task), so
+            * the tasks can use it as scratch memory that lives only during
+            * their current run.
+            * @warning Blocks allocated from a bound arena should not be kept
+            * between activations.
+            * @param[in] a The arena.
+            * @return Returns @c true on success, otherwise returns @c false.
+            */
+            bool bindArena( mem::arena &a ) noexcept;
+            /**
+            * @brief Unbind an arena from the scheduling cycle.
+            * @param[in] a The arena.
+            * @return Returns @c true on success, @c false if the arena was not
+            * bound.
+            */
+            bool unbindArena( mem::arena &a ) noexcept;
+            /**
             * @brief Retrieve the task global-state.
             * @param[in] Task The task node.
             * @return One of the available global states : globalState::WAITING,
@@ -72,7 +72,7 @@ namespace qOS {
             * @brief Get a pointer to the list in which this node is contained.
             * @return A pointer to the list container.
             */
-            inline list* getContainer( void ) noexcept
+            inline list* getContainer( void ) const noexcept
             {
                 return container;
             }
@@ -1,18 +1,28 @@
 #ifndef QOS_CPP_MEMORY
 #define QOS_CPP_MEMORY
 
+#include "config/config.h"
 #include "include/types.hpp"
+#include "include/clock.hpp"
 
 #ifndef Q_BYTE_ALIGNMENT
     #define Q_BYTE_ALIGNMENT        ( 8 )
 #endif
 
+#ifndef Q_MEM_DEBUG
+    #define Q_MEM_DEBUG             ( 0 )
+#endif
+
 #if ( ( Q_BYTE_ALIGNMENT != 1 ) && ( Q_BYTE_ALIGNMENT != 2 ) && ( Q_BYTE_ALIGNMENT != 4 ) && ( Q_BYTE_ALIGNMENT != 8 ) )
     #error Q_BYTE_ALIGNMENT value not allowed, use only 1,2,4 or 8(default).
 #endif
 
 namespace qOS {
 
+    /*! @cond */
+    class core;
+    /*! @endcond */
+
     /**
     * @brief Memory management interfaces.
     */
@@ -29,8 +39,53 @@ namespace qOS {
             blockConnect_t *next{ nullptr };
             size_t blockSize{ 0u };
         };
+        struct tlsfControl;
         /*! @endcond */
 
+        /**
+        * @brief The statistics of a memory pool. See mem::pool::getStats()
+        */
+        struct poolStats {
+            size_t freeBytes{ 0u };         /**< The heap space that remains unallocated.*/
+            size_t minEverFreeBytes{ 0u };  /**< The lowest amount of unallocated heap space since the pool was initialized (high-water mark).*/
+            size_t largestFreeBlock{ 0u };  /**< The largest request that can be served at this moment.*/
+            size_t freeBlocks{ 0u };        /**< The number of free blocks. A high value relative to freeBytes means fragmentation.*/
+            size_t allocations{ 0u };       /**< The number of successful allocations.*/
+            size_t frees{ 0u };             /**< The number of deallocations.*/
+            size_t failedAllocations{ 0u }; /**< The number of allocations that could not be served.*/
+        };
+
+        /**
+        * @brief The information of a live allocation reported by
+        * mem::pool::walk()
+        */
+        struct blockInfo {
+            void *ptr{ nullptr };           /**< The pointer returned by the allocation.*/
+            size_t size{ 0u };              /**< The usable size. The requested size when @c Q_MEM_DEBUG is enabled.*/
+            const char *site{ nullptr };    /**< The allocation site. Only with @c Q_MEM_DEBUG.*/
+            qOS::clock_t tick{ 0u };        /**< The OS tick at the allocation. Only with @c Q_MEM_DEBUG.*/
+            size_t sequence{ 0u };          /**< The allocation number, see poolStats::allocations. Only with @c Q_MEM_DEBUG.*/
+        };
+
+        /**
+        * @brief Pointer to the function called by mem::pool::walk() for every
+        * live allocation.
+        * @param info The allocation information.
+        * @param arg The user argument supplied in mem::pool::walk().
+        */
+        using walkFcn_t = void (*)( const blockInfo &info, void *arg );
+
+        /**
+        * @brief An enum with the allocation policies of a memory pool.
+        * @note A latency and fragmentation benchmark of both policies is
+        * available in check/tlsf_bench.cpp. It is built with the
+        * @c QUARKTS_BUILD_CHECKS CMake option.
+        */
+        enum class poolPolicy : uint8_t {
+            FIRST_FIT,  /**< Address-ordered free list with the First-Fit approach. Default and smallest footprint.*/
+            TLSF,       /**< Two-Level Segregated Fit. Allocation and deallocation take bounded time.*/
+        };
+
         /**
         * @brief A Memory Pool object
         * @details A memory pool its a special resource that allows memory blocks to
@@ -46,8 +101,21 @@ namespace qOS {
                 uint8_t *poolMemory{ nullptr };
                 size_t poolMemSize{ 0u };
                 size_t freeBytesRemaining{ 0u };
+                tlsfControl *control{ nullptr };
+                size_t minEverFree{ 0u };
+                size_t nAllocs{ 0u };
+                size_t nFrees{ 0u };
+                size_t nFailed{ 0u };
+                void* rawAlloc( size_t pSize ) noexcept;
+                void rawFree( void *ptr ) noexcept;
+                size_t scan( walkFcn_t fcn, void *arg, poolStats *s ) const noexcept;
                 void insertBlockIntoFreeList( blockConnect_t *xBlock ) noexcept;
                 void init( void ) noexcept;
+                bool tlsfInit( void ) noexcept;
+                void* firstFitAlloc( size_t pSize ) noexcept;
+                void firstFitFree( void *ptr ) noexcept;
+                void* tlsfAlloc( const size_t pSize ) noexcept;
+                void tlsfFree( void *ptr ) noexcept;
                 pool( pool const& ) = delete;
                 void operator=( pool const& ) = delete;
             public:
@@ -58,10 +126,10 @@ namespace qOS {
                 * allocated to act as Heap of the memory pool. The size of this block should
                 * match the @a pSize argument.
                 * @param[in] pSize The size of the memory block pointed by @a pArea
-                * @return Returns @c true on success, otherwise, returns @c false.
+                * @param[in] policy The allocation policy of the pool.
                 */
-                inline pool( void *pArea, const size_t pSize ) noexcept {
-                    (void)setup( pArea, pSize );
+                inline pool( void *pArea, const size_t pSize, const poolPolicy policy = poolPolicy::FIRST_FIT ) noexcept {
+                    (void)setup( pArea, pSize, policy );
                 }
                 /**
                 * @brief Initializes a memory pool instance. This function should be called
@@ -70,9 +138,14 @@ namespace qOS {
                 * allocated to act as Heap of the memory pool. The size of this block should
                 * match the @a pSize argument.
                 * @param[in] pSize The size of the memory block pointed by @a pArea
+                * @param[in] policy The allocation policy of the pool. With
+                * poolPolicy::TLSF, the pool keeps its segregated lists at the
+                * beginning of @a pArea and alloc/free take bounded time, which
+                * suits real-time code. The lists take some hundred bytes that
+                * grow with the logarithm of @a pSize
                 * @return Returns @c true on success, otherwise, returns @c false.
                 */
-                bool setup( void *pArea, const size_t pSize ) noexcept;
+                bool setup( void *pArea, const size_t pSize, const poolPolicy policy = poolPolicy::FIRST_FIT ) noexcept;
                 /**
                 * @brief Deallocates the space previously allocated by mem::pool::alloc().
                 * Deallocation will be performed in the selected memory pool.
@@ -96,17 +169,307 @@ namespace qOS {
                 * returned to the beginning of the memory block.
                 * @attention This method is NOT interrupt-safe.
                 * @param[in] pSize Size of the memory block in bytes.
+                * @param[in] site An optional tag of the allocation site, for
+                * example @c __func__. It is recorded with the tick of the
+                * allocation when @c Q_MEM_DEBUG is enabled. The string should
+                * outlive the allocation.
                 * @return If the request is successful then a pointer to the memory block is
                 * returned. If the function failed to allocate the requested block of memory
                 * , a @c nullptr pointer is returned.
                 */
-                void* alloc( size_t pSize ) noexcept;
+                void* alloc( size_t pSize, const char *site = nullptr ) noexcept;
                 /**
                 * @brief Returns the total amount of heap space that remains unallocated for
                 * the memory pool.
                 * @return The size of the unallocated heap.
                 */
                 size_t getFreeSize( void ) const noexcept;
+                /**
+                * @brief Get the usage and fragmentation statistics of the pool.
+                * @note The largest free block and the free-block count are
+                * obtained by walking the heap, so this call takes a time
+                * proportional to the number of blocks.
+                * @return The statistics of the pool.
+                */
+                poolStats getStats( void ) const noexcept;
+                /**
+                * @brief Walk the heap and report every live allocation.
+                * @details Used to dump the allocations, for example to find a
+                * leak by comparing the allocations made after a known point.
+                * With @c Q_MEM_DEBUG enabled, every allocation carries its
+                * site, tick and sequence number, so a snapshot is just the
+                * value of poolStats::allocations at that point.
+                * @attention This method is NOT interrupt-safe.
+                * @param[in] fcn The function called for every live allocation.
+                * Can be @c nullptr to only count them.
+                * @param[in] arg An user argument passed to @a fcn
+                * @return The number of live allocations.
+                */
+                size_t walk( walkFcn_t fcn, void *arg = nullptr ) const noexcept;
+        };
+
+        /**
+        * @brief A fixed-size block allocator (slab).
+        * @details A slab splits a user-designated memory region in blocks of the
+        * same size and keeps the free ones in a singly-linked list, so
+        * mem::slab::alloc() and mem::slab::free() are O(1) operations that never
+        * fragment the memory. Several slabs of different block sizes can be
+        * combined with a mem::slabHeap to serve the common object sizes of an
+        * application.
+        */
+        class slab {
+            private:
+                void *freeList{ nullptr };
+                uint8_t *first{ nullptr };
+                uint8_t *last{ nullptr };
+                size_t blockSize{ 0u };
+                size_t nFree{ 0u };
+                size_t nBlocks{ 0u };
+                slab *nextClass{ nullptr };
+                slab( slab const& ) = delete;
+                void operator=( slab const& ) = delete;
+            public:
+                slab() = default;
+                virtual ~slab() {}
+                /**
+                * @brief Initializes a slab instance.
+                * @param[in] pArea A pointer to a memory block statically
+                * allocated to hold the blocks of the slab.
+                * @param[in] pSize The size of the memory block pointed by @a pArea
+                * @param[in] bSize The size in bytes of every block. This value
+                * will be rounded up to a multiple of @c Q_BYTE_ALIGNMENT
+                */
+                inline slab( void *pArea, const size_t pSize, const size_t bSize ) noexcept
+                {
+                    (void)setup( pArea, pSize, bSize );
+                }
+                /**
+                * @brief Initializes a slab instance. This function should be
+                * called once before any memory request.
+                * @param[in] pArea A pointer to a memory block statically
+                * allocated to hold the blocks of the slab.
+                * @param[in] pSize The size of the memory block pointed by @a pArea
+                * @param[in] bSize The size in bytes of every block. This value
+                * will be rounded up to a multiple of @c Q_BYTE_ALIGNMENT
+                * @return Returns @c true on success, otherwise, returns @c false.
+                */
+                bool setup( void *pArea, const size_t pSize, const size_t bSize ) noexcept;
+                /**
+                * @brief Allocate a block from the slab.
+                * @attention This method is NOT interrupt-safe.
+                * @return A pointer to the block or @c nullptr if there are no
+                * free blocks left.
+                */
+                void* alloc( void ) noexcept;
+                /**
+                * @brief Return a block previously obtained with mem::slab::alloc().
+                * If @a ptr is a @c nullptr pointer or does not point to a block
+                * of the slab, the function does nothing.
+                * @attention This method is NOT interrupt-safe.
+                * @param[in] ptr The block to deallocate.
+                */
+                void free( void *ptr ) noexcept;
+                /**
+                * @brief Check if a pointer lies inside the memory region of the
+                * slab.
+                * @param[in] ptr The pointer to check.
+                * @return @c true if @a ptr belongs to the slab, otherwise returns
+                * @c false.
+                */
+                bool owns( const void *ptr ) const noexcept;
+                /**
+                * @brief Get the size of every block of the slab.
+                * @return The block size in bytes.
+                */
+                size_t getBlockSize( void ) const noexcept;
+                /**
+                * @brief Get the number of blocks that remain unallocated.
+                * @return The number of free blocks.
+                */
+                size_t getFreeBlocks( void ) const noexcept;
+                /**
+                * @brief Get the total number of blocks of the slab.
+                * @return The number of blocks.
+                */
+                size_t getTotalBlocks( void ) const noexcept;
+            friend class slabHeap;
+        };
+
+        /**
+        * @brief A size-class allocator built from slabs and a memory pool.
+        * @details Every slab added to the heap serves one size class. A request
+        * is routed to the smallest class whose blocks can hold it, spilling
+        * over to the larger classes when it is exhausted, and requests larger
+        * than every class fall back to a mem::pool. Small objects are then
+        * allocated and freed in O(1) time, while the pool only deals with the
+        * large and infrequent ones.
+        *
+        * Example:
+        * @code{.c}
+        * static uint8_t a16[ 64*16 ], a64[ 32*64 ], a256[ 8*256 ], aHeap[ 4096 ];
+        * mem::slab s16( a16, sizeof(a16), 16 );
+        * mem::slab s64( a64, sizeof(a64), 64 );
+        * mem::slab s256( a256, sizeof(a256), 256 );
+        * mem::pool big( aHeap, sizeof(aHeap) );
+        * mem::slabHeap heap( &big );
+        *
+        * heap.addClass( s16 );
+        * heap.addClass( s64 );
+        * heap.addClass( s256 );
+        * msg_t *m = static_cast<msg_t*>( heap.alloc( sizeof(msg_t) ) );
+        * heap.free( m );
+        * @endcode
+        */
+        class slabHeap {
+            private:
+                slab *classes{ nullptr };
+                pool *fallback{ nullptr };
+                slabHeap( slabHeap const& ) = delete;
+                void operator=( slabHeap const& ) = delete;
+            public:
+                virtual ~slabHeap() {}
+                /**
+                * @brief Initializes a size-class heap.
+                * @param[in] large The memory pool used for the requests that
+                * do not fit in any slab. Pass @c nullptr to serve only the
+                * sizes of the slabs.
+                */
+                explicit slabHeap( pool *large = nullptr ) noexcept : fallback( large ) {}
+                /**
+                * @brief Add a slab as a size class of the heap.
+                * @param[in] s The slab. It should be initialized and not belong
+                * to another heap.
+                * @return Returns @c true on success, otherwise, returns @c false.
+                */
+                bool addClass( slab &s ) noexcept;
+                /**
+                * @brief Allocate a block of memory that is @a pSize bytes large.
+                * @attention This method is NOT interrupt-safe.
+                * @param[in] pSize Size of the memory block in bytes.
+                * @return A pointer to the memory block or @c nullptr if the
+                * request could not be served.
+                */
+                void* alloc( const size_t pSize ) noexcept;
+                /**
+                * @brief Deallocates the space previously allocated by
+                * mem::slabHeap::alloc(). The memory is returned to the slab that
+                * owns it or to the fallback pool.
+                * @attention This method is NOT interrupt-safe.
+                * @param[in] ptr to the memory to deallocate
+                */
+                void free( void *ptr ) noexcept;
+        };
+
+        /**
+        * @brief A region allocator for short-lived scratch memory.
+        * @details An arena hands out memory by bumping an offset inside a
+        * user-designated memory region, so an allocation costs a few
+        * instructions and there is no per-object deallocation. Instead, the
+        * whole region is released at once with mem::arena::reset(), or back to
+        * a previous point with mem::arena::mark() and mem::arena::rewind().
+        * An arena bound to the kernel with core::bindArena() is reset after
+        * every task activation, so it can hold the temporary objects that a
+        * task builds and drops on each run, like formatted responses or
+        * parsed frames.
+        */
+        class arena {
+            private:
+                uint8_t *base{ nullptr };
+                size_t size{ 0u };
+                size_t offset{ 0u };
+                size_t peak{ 0u };
+                arena *nextBound{ nullptr };
+                arena( arena const& ) = delete;
+                void operator=( arena const& ) = delete;
+            public:
+                arena() = default;
+                virtual ~arena() {}
+                /**
+                * @brief Initializes an arena instance.
+                * @param[in] pArea A pointer to a memory block statically
+                * allocated to hold the arena.
+                * @param[in] pSize The size of the memory block pointed by @a pArea
+                */
+                inline arena( void *pArea, const size_t pSize ) noexcept
+                {
+                    (void)setup( pArea, pSize );
+                }
+                /**
+                * @brief Initializes an arena instance.
+                * @param[in] pArea A pointer to a memory block statically
+                * allocated to hold the arena.
+                * @param[in] pSize The size of the memory block pointed by @a pArea
+                * @return Returns @c true on success, otherwise, returns @c false.
+                */
+                bool setup( void *pArea, const size_t pSize ) noexcept;
+                /**
+                * @brief Allocate a block of memory that is @a pSize bytes large.
+                * The block is aligned to @c Q_BYTE_ALIGNMENT
+                * @attention This method is NOT interrupt-safe.
+                * @param[in] pSize Size of the memory block in bytes.
+                * @return A pointer to the memory block or @c nullptr if the
+                * arena does not have enough space.
+                */
+                void* alloc( const size_t pSize ) noexcept;
+                /**
+                * @brief Get the current position of the arena.
+                * @return A mark that can be passed to mem::arena::rewind()
+                */
+                size_t mark( void ) const noexcept;
+                /**
+                * @brief Release every block allocated after the given mark.
+                * @param[in] m A mark obtained with mem::arena::mark()
+                * @return Returns @c true on success, @c false if @a m is beyond
+                * the current position.
+                */
+                bool rewind( const size_t m ) noexcept;
+                /**
+                * @brief Release all the blocks of the arena.
+                */
+                void reset( void ) noexcept;
+                /**
+                * @brief Returns the amount of space that remains unallocated.
+                * @return The number of free bytes.
+                */
+                size_t getFreeSize( void ) const noexcept;
+                /**
+                * @brief Returns the highest amount of space used since the
+                * arena was initialized.
+                * @return The peak usage in bytes.
+                */
+                size_t getPeak( void ) const noexcept;
+            friend class qOS::core;
+        };
+
+        /**
+        * @brief A scoped guard that rewinds an arena when it goes out of
+        * scope, releasing every block allocated during its lifetime.
+        *
+        * Example:
+        * @code{.c}
+        * void formatReport( mem::arena &scratch ) {
+        *     mem::arenaScope scope( scratch );
+        *     char *line = static_cast<char*>( scratch.alloc( 64 ) );
+        *     ...
+        * } // line is released here
+        * @endcode
+        */
+        class arenaScope final {
+            private:
+                arena &a;
+                size_t m;
+                arenaScope( arenaScope const& ) = delete;
+                void operator=( arenaScope const& ) = delete;
+            public:
+                /**
+                * @brief Mark the current position of the arena.
+                * @param[in] x The arena to guard.
+                */
+                explicit arenaScope( arena &x ) noexcept : a( x ), m( x.mark() ) {}
+                ~arenaScope()
+                {
+                    (void)a.rewind( m );
+                }
         };
 
         /** @}*/
@@ -114,12 +477,50 @@ namespace qOS {
 }
 
     #if ( Q_DEFAULT_HEAP_SIZE >= 64 )
+        /*! @cond */
+        #if !defined( ARDUINO_PLATFORM ) && ( defined( __unix__ ) || defined( __APPLE__ ) || defined( _WIN32 ) )
+            #define Q_DEFAULT_HEAP_THREAD_CACHE
+        #endif
+        /*! @endcond */
+
+        namespace qOS {
+            namespace mem {
+                /** @addtogroup qmemmang
+                *  @{
+                */
+
+                /**
+                * @brief Pointer to the function called when the default pool
+                * can not serve a @c new request.
+                * @param size The size of the failed request.
+                * @return @c true if memory was released and the request
+                * should be retried, otherwise @c false and @c new returns
+                * @c nullptr
+                */
+                using outOfMemoryFcn_t = bool (*)( size_t size );
+
+                /**
+                * @brief Set the function that is called when the default pool
+                * runs out of memory.
+                * @note Should be set before any thread uses @c new
+                * @param[in] fcn The out-of-memory hook. Pass @c nullptr to
+                * remove it.
+                */
+                void setOutOfMemoryHook( outOfMemoryFcn_t fcn ) noexcept;
+
+                /** @}*/
+            }
+        }
+
         void * operator new( size_t size);
         void * operator new[]( size_t size);
 
         void operator delete(void * ptr) noexcept;
         void operator delete[](void * ptr) noexcept;
 
+        void operator delete( void *ptr, size_t size ) noexcept;
+        void operator delete[]( void *ptr, size_t size ) noexcept;
+
         void operator delete(void* ptr, void* place) noexcept;
         void operator delete[](void* ptr, void* place) noexcept;
     #endif /*Q_USE_MEM_ALLOCATION_SCHEME*/
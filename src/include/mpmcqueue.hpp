@@ -0,0 +1,309 @@
+#ifndef QOS_CPP_MPMC_QUEUE
+#define QOS_CPP_MPMC_QUEUE
+
+#include "include/types.hpp"
+#include "include/queue.hpp"
+
+/*! @cond  */
+#if !defined( ARDUINO_PLATFORM ) && ( defined( __unix__ ) || defined( __APPLE__ ) || defined( _WIN32 ) )
+    #define Q_MPMC_QUEUE_AVAILABLE
+    #include <atomic>
+#endif
+/*! @endcond  */
+
+#if defined( Q_MPMC_QUEUE_AVAILABLE )
+
+namespace qOS {
+
+    /** @addtogroup qqueues
+    * @{
+    */
+
+    /**
+    * @brief A bounded multi-producer/multi-consumer lock-free queue for hosted
+    * multi-threaded builds.
+    * @details Every slot of the ring holds a sequence number that tells
+    * producers and consumers whether the slot is ready to be written or read,
+    * so threads synchronize with atomic operations only and the global
+    * critical section is never used. As it inherits from qOS::queue, the
+    * queue can be attached to a task with task::attachQueue(), so worker
+    * threads can feed the kernel tasks directly.
+    *
+    * Example:
+    * @code{.c}
+    * mpmcQueue<job_t, 64> jobs;
+    *
+    * void worker( void ) { // runs on a std::thread
+    *     job_t j = makeJob();
+    *     while ( !jobs.send( j ) ) {
+    *         std::this_thread::sleep_for( std::chrono::microseconds( 10 ) );
+    *     }
+    * }
+    *
+    * void jobTask_Callback( event_t e ) {
+    *     job_t *j = static_cast<job_t*>( e.EventData );
+    *     process( j );
+    * }
+    *
+    * tJobs.attachQueue( jobs, queueLinkMode::QUEUE_RECEIVER );
+    * @endcode
+    * @note The queueSendMode::TO_FRONT mode and the in-place APIs
+    * (queue::reserve(), queue::commit(), queue::peek( size_t& ) and
+    * queue::release()) are not supported. The watermarks and the occupancy
+    * statistics of qOS::queue are not maintained either, as they would
+    * require the critical section.
+    * @warning When the queue is attached in the queueLinkMode::QUEUE_RECEIVER
+    * mode, the kernel should be the only consumer, because the front item is
+    * peeked before the task runs and removed after it.
+    * @note A stress test and a throughput benchmark are available in
+    * check/mpmc_stress_test.cpp and check/mpmc_bench.cpp. They are built
+    * with the @c QUARKTS_BUILD_CHECKS CMake option.
+    * @pre @a T should be a trivially copyable type.
+    * @tparam T The type of the items.
+    * @tparam N The maximum number of items. Should be a power of two.
+    */
+    template <typename T, size_t N>
+    class mpmcQueue final : public queue {
+        static_assert( ( N > 1u ) && ( 0u == ( N & ( N - 1u ) ) ), "The mpmc queue length should be a power of two" );
+        private:
+            struct cell {
+                std::atomic<size_t> seq;
+                T data;
+            };
+            static const size_t MASK = N - 1u;
+            alignas( 64 ) cell cells[ N ];
+            alignas( 64 ) std::atomic<size_t> enqueuePos;
+            alignas( 64 ) std::atomic<size_t> dequeuePos;
+            using queue::setup;
+            mpmcQueue( mpmcQueue const& ) = delete;
+            void operator=( mpmcQueue const& ) = delete;
+            template <typename Action>
+            inline bool pop( Action action ) noexcept
+            {
+                bool retValue = false;
+                size_t pos = dequeuePos.load( std::memory_order_relaxed );
+
+                for ( ;; ) {
+                    cell &c = cells[ pos & MASK ];
+                    const size_t seq = c.seq.load( std::memory_order_acquire );
+                    const size_t expected = pos + 1u;
+
+                    if ( seq == expected ) {
+                        if ( dequeuePos.compare_exchange_weak( pos, pos + 1u, std::memory_order_relaxed ) ) {
+                            action( c.data );
+                            c.seq.store( pos + N, std::memory_order_release );
+                            retValue = true;
+                            break;
+                        }
+                    }
+                    else if ( seq < expected ) {
+                        break; /*the queue is empty*/
+                    }
+                    else {
+                        pos = dequeuePos.load( std::memory_order_relaxed );
+                    }
+                }
+
+                return retValue;
+            }
+        public:
+            mpmcQueue() noexcept
+            {
+                (void)queue::setup( cells, sizeof(T), N );
+            }
+            /**
+            * @brief Post an item to the back of the queue by copy. Can be
+            * called from any thread.
+            * @param[in] item The item to be placed on the queue.
+            * @return @c true on successful add, @c false if the queue is full.
+            */
+            inline bool send( const T &item ) noexcept
+            {
+                bool retValue = false;
+                size_t pos = enqueuePos.load( std::memory_order_relaxed );
+
+                for ( ;; ) {
+                    cell &c = cells[ pos & MASK ];
+                    const size_t seq = c.seq.load( std::memory_order_acquire );
+
+                    if ( seq == pos ) {
+                        if ( enqueuePos.compare_exchange_weak( pos, pos + 1u, std::memory_order_relaxed ) ) {
+                            c.data = item;
+                            c.seq.store( pos + 1u, std::memory_order_release );
+                            retValue = true;
+                            break;
+                        }
+                    }
+                    else if ( seq < pos ) {
+                        break; /*the queue is full*/
+                    }
+                    else {
+                        pos = enqueuePos.load( std::memory_order_relaxed );
+                    }
+                }
+
+                return retValue;
+            }
+            /**
+            * @brief Receive an item from the queue (and removes it). Can be
+            * called from any thread.
+            * @param[out] item The variable where the item will be copied.
+            * @return @c true if an item was received, otherwise returns @c false.
+            */
+            inline bool receive( T &item ) noexcept
+            {
+                return pop( [&item]( const T &d ) { item = d; } );
+            }
+            /** @brief See queue::send() */
+            bool send( void *itemToQueue, const queueSendMode pos = queueSendMode::TO_BACK ) noexcept override
+            {
+                bool retValue = false;
+                /*cstat -CERT-EXP36-C_b*/
+                if ( ( nullptr != itemToQueue ) && ( queueSendMode::TO_BACK == pos ) ) {
+                    retValue = send( *static_cast<const T*>( itemToQueue ) );
+                }
+                /*cstat +CERT-EXP36-C_b*/
+                return retValue;
+            }
+            /** @brief See queue::receive() */
+            bool receive( void *dst ) noexcept override
+            {
+                /*cstat -CERT-EXP36-C_b*/
+                return ( nullptr != dst ) ? receive( *static_cast<T*>( dst ) ) : false;
+                /*cstat +CERT-EXP36-C_b*/
+            }
+            /** @brief See queue::sendMany() */
+            size_t sendMany( const void *src, const size_t n ) noexcept override
+            {
+                size_t k = 0u;
+
+                if ( nullptr != src ) {
+                    /*cstat -CERT-EXP36-C_b*/
+                    const T * const s = static_cast<const T*>( src );
+                    /*cstat +CERT-EXP36-C_b*/
+                    while ( ( k < n ) && send( s[ k ] ) ) {
+                        ++k;
+                    }
+                }
+
+                return k;
+            }
+            /** @brief See queue::receiveMany() */
+            size_t receiveMany( void *dst, const size_t n ) noexcept override
+            {
+                size_t k = 0u;
+
+                if ( nullptr != dst ) {
+                    /*cstat -CERT-EXP36-C_b*/
+                    T * const d = static_cast<T*>( dst );
+                    /*cstat +CERT-EXP36-C_b*/
+                    while ( ( k < n ) && receive( d[ k ] ) ) {
+                        ++k;
+                    }
+                }
+
+                return k;
+            }
+            /** @brief See queue::peek() */
+            void* peek( void ) const noexcept override
+            {
+                void *front = nullptr;
+                const size_t pos = dequeuePos.load( std::memory_order_relaxed );
+                const cell &c = cells[ pos & MASK ];
+
+                if ( ( pos + 1u ) == c.seq.load( std::memory_order_acquire ) ) {
+                    front = const_cast<T*>( &c.data );
+                }
+
+                return front;
+            }
+            /** @brief See queue::removeFront() */
+            bool removeFront( void ) noexcept override
+            {
+                return pop( []( const T &d ) { Q_UNUSED( d ); } );
+            }
+            /**
+            * @brief Not supported. The in-place APIs require a single producer.
+            * @param[out] n Always set to zero.
+            * @return Always @c nullptr.
+            */
+            void* reserve( size_t &n ) noexcept override
+            {
+                n = 0u;
+                return nullptr;
+            }
+            /**
+            * @brief Not supported. The in-place APIs require a single producer.
+            * @param[in] n Unused.
+            * @return Always @c false.
+            */
+            bool commit( const size_t n ) noexcept override
+            {
+                Q_UNUSED( n );
+                return false;
+            }
+            /**
+            * @brief Not supported. The in-place APIs require a single consumer.
+            * @param[out] n Always set to zero.
+            * @return Always @c nullptr.
+            */
+            void* peek( size_t &n ) noexcept override
+            {
+                n = 0u;
+                return nullptr;
+            }
+            /**
+            * @brief Not supported. The in-place APIs require a single consumer.
+            * @param[in] n Unused.
+            * @return Always @c false.
+            */
+            bool release( const size_t n ) noexcept override
+            {
+                Q_UNUSED( n );
+                return false;
+            }
+            /**
+            * @brief Resets the queue to its original empty state.
+            * @warning Not thread-safe. No other thread should use the queue
+            * during this call.
+            */
+            void reset( void ) noexcept override
+            {
+                for ( size_t i = 0u ; i < N ; ++i ) {
+                    cells[ i ].seq.store( i, std::memory_order_relaxed );
+                }
+                enqueuePos.store( 0u, std::memory_order_relaxed );
+                dequeuePos.store( 0u, std::memory_order_release );
+            }
+            /** @brief See queue::count() */
+            size_t count( void ) const noexcept override
+            {
+                const size_t d = dequeuePos.load( std::memory_order_acquire );
+                const size_t e = enqueuePos.load( std::memory_order_acquire );
+                const size_t c = e - d;
+                /*the positions are read at different moments*/
+                return ( c > N ) ? N : c;
+            }
+            /** @brief See queue::isEmpty() */
+            bool isEmpty( void ) const noexcept override
+            {
+                return ( 0u == count() );
+            }
+            /** @brief See queue::isFull() */
+            bool isFull( void ) const noexcept override
+            {
+                return ( N == count() );
+            }
+            /** @brief See queue::itemsAvailable() */
+            size_t itemsAvailable( void ) const noexcept override
+            {
+                return N - count();
+            }
+    };
+
+    /** @}*/
+}
+
+#endif /*Q_MPMC_QUEUE_AVAILABLE*/
+
+#endif /*QOS_CPP_MPMC_QUEUE*/
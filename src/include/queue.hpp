@@ -2,6 +2,7 @@
 #define QOS_CPP_QUEUE
 
 #include "include/types.hpp"
+#include "include/critical.hpp"
 
 namespace qOS {
 
@@ -19,6 +20,10 @@ namespace qOS {
         TO_FRONT    /*< to indicate whether the item in the queue should be sent to the front. */
     };
 
+    /*! @cond  */
+    class task;
+    /*! @endcond  */
+
     /**
     * @brief A Queue object
     * @details A queue is a linear data structure with simple operations based
@@ -43,18 +48,32 @@ namespace qOS {
     */
     class queue {
         private:
-            uint8_t *head{ nullptr };
             uint8_t *tail{ nullptr };
             uint8_t *writer{ nullptr };
             uint8_t *reader{ nullptr };
-            volatile size_t itemsWaiting = 0u;
-            size_t itemsCount = 0u;
-            size_t itemSize = 0u;
             void moveReader( void ) noexcept;
+            uint8_t* front( void ) const noexcept;
+            uint8_t* advance( uint8_t *p, const size_t n ) const noexcept;
+            size_t wmHigh{ 0u };
+            size_t wmLow{ 0u };
+            bool wmAbove{ false };
+            task *wmTask{ nullptr };
+            size_t peak{ 0u };
+            uint32_t overflows{ 0u };
+            uint32_t enqueued{ 0u };
             void copyDataFromQueue( void * const dst ) noexcept;
             void copyDataToQueue( const void *itemToQueue, const queueSendMode xPosition ) noexcept; 
             queue( queue const& ) = delete;
             void operator=( queue const& ) = delete;
+        protected:
+            /*! @cond  */
+            uint8_t *head{ nullptr };
+            volatile size_t itemsWaiting = 0u;
+            size_t itemsCount = 0u;
+            size_t itemSize = 0u;
+            void afterSend( const size_t sent, const size_t dropped ) noexcept;
+            void afterRemove( void ) noexcept;
+            /*! @endcond  */
         public:
             queue() = default;
             virtual ~queue() {}
@@ -70,34 +89,34 @@ namespace qOS {
             /**
             * @brief Resets a queue to its original empty state.
             */
-            void reset( void ) noexcept;
+            virtual void reset( void ) noexcept;
             /**
             * @brief Returns the empty status of the Queue
             * @return @c true if the Queue is empty, @c false if it is not.
             */
-            bool isEmpty( void ) const noexcept;
+            virtual bool isEmpty( void ) const noexcept;
             /**
             * @brief Returns the full status of the Queue
             * @return @c true if the Queue is full, @c false if it is not.
             */
-            bool isFull( void ) const noexcept;
+            virtual bool isFull( void ) const noexcept;
             /**
             * @brief Returns the number of items in the Queue
             * @return The number of elements in the queue
             */
-            size_t count( void ) const noexcept;
+            virtual size_t count( void ) const noexcept;
             /**
             * @brief Returns the number of available slots to hold items inside 
             * the queue.
             * @return The number of available slots in the queue.
             */
-            size_t itemsAvailable( void ) const noexcept;
+            virtual size_t itemsAvailable( void ) const noexcept;
             /**
             * @brief Remove the data located at the front of the Queue
             * @return @c true if data was removed from the Queue, otherwise returns
             * @c false
             */
-            bool removeFront( void ) noexcept;
+            virtual bool removeFront( void ) noexcept;
             /**
             * @brief Receive an item from a queue (and removes it). The item is 
             * received by copy so a buffer of adequate size must be provided.
@@ -108,7 +127,7 @@ namespace qOS {
             * @return @c true if data was retrieved from the Queue, otherwise returns
             * @c false
             */
-            bool receive( void *dst ) noexcept;
+            virtual bool receive( void *dst ) noexcept;
             /**
             * @brief Post an item to the the queue. The item is queued by copy,
             * not by reference
@@ -121,12 +140,12 @@ namespace qOS {
             * to place the item at the front of the queue (for high priority messages).
             * @return @c true on successful add, @c false if not added
             */
-            bool send( void *itemToQueue, const queueSendMode pos = queueSendMode::TO_BACK ) noexcept;
+            virtual bool send( void *itemToQueue, const queueSendMode pos = queueSendMode::TO_BACK ) noexcept;
             /**
             * @brief Looks at the data from the front of the Queue without removing it.
             * @return Pointer to the data, or @c nullptr if there is nothing in the queue.
             */
-            void* peek( void ) const noexcept;
+            virtual void* peek( void ) const noexcept;
             /**
             * @brief Check if the queue is already initialized by using queue::setup()
             * @return @c true if the queue is initialized, @c false if not.
@@ -137,6 +156,368 @@ namespace qOS {
             * @return The item-size in bytes.
             */
             size_t getItemSize( void ) const noexcept;
+            /**
+            * @brief Post up to @a n items to the back of the queue. All the
+            * items are copied inside a single critical section.
+            * @param[in] src A pointer to the array of items to be queued.
+            * @param[in] n The number of items in @a src
+            * @return The number of items queued. It can be lower than @a n if
+            * the queue does not have enough free slots.
+            */
+            virtual size_t sendMany( const void *src, const size_t n ) noexcept;
+            /**
+            * @brief Receive up to @a n items from the front of the queue (and
+            * removes them). All the items are copied inside a single critical
+            * section.
+            * @param[out] dst A pointer to the buffer into which the items will be
+            * copied. It should be able to hold @a n items.
+            * @param[in] n The maximum number of items to receive.
+            * @return The number of items received.
+            */
+            virtual size_t receiveMany( void *dst, const size_t n ) noexcept;
+            /**
+            * @brief Get direct access to the contiguous free region at the back
+            * of the queue, so the producer can write the items in place. The
+            * items are queued later with queue::commit().
+            * @note Only a single producer should use this API at a time.
+            * @param[in,out] n The maximum number of items wanted. On return,
+            * the number of contiguous items that can be written.
+            * @return A pointer to the writable region or @c nullptr if the queue
+            * is full.
+            */
+            virtual void* reserve( size_t &n ) noexcept;
+            /**
+            * @brief Queue the items written in place after a call to
+            * queue::reserve().
+            * @param[in] n The number of items written. Should not be greater
+            * than the value granted by queue::reserve().
+            * @return @c true on success, otherwise returns @c false.
+            */
+            virtual bool commit( const size_t n ) noexcept;
+            /**
+            * @brief Get direct access to the contiguous region at the front of
+            * the queue, so the consumer can process the items in place. The
+            * items are removed later with queue::release().
+            * @note Only a single consumer should use this API at a time.
+            * @param[out] n The number of contiguous items available.
+            * @return A pointer to the front item or @c nullptr if the queue is
+            * empty.
+            */
+            virtual void* peek( size_t &n ) noexcept;
+            /**
+            * @brief Remove items from the front of the queue after processing
+            * them in place with queue::peek( size_t& ).
+            * @param[in] n The number of items to remove.
+            * @return @c true on success, @c false if @a n is zero or greater than
+            * the number of items in the queue.
+            */
+            virtual bool release( const size_t n ) noexcept;
+            /**
+            * @brief Set the high and low watermarks of the queue. A task
+            * attached with queueLinkMode::QUEUE_WATERMARKS is triggered with
+            * trigger::byQueueHighWatermark when the number of items rises to
+            * @a high, and with trigger::byQueueLowWatermark when it falls back
+            * to @a low. The crossings are detected by the send and receive
+            * operations, which hand them to the attached task in the order
+            * they happened. The hysteresis between both levels avoids
+            * repeated events around a single level.
+            * @param[in] high The high watermark. Should not be greater than the
+            * queue length.
+            * @param[in] low The low watermark. Should be lower than @a high.
+            * @return @c true on success, otherwise returns @c false.
+            */
+            bool setWatermarks( const size_t high, const size_t low ) noexcept;
+            /**
+            * @brief Get the highest number of items that the queue has held.
+            * @return The peak occupancy of the queue.
+            */
+            size_t getPeak( void ) const noexcept;
+            /**
+            * @brief Get the number of items that could not be sent because the
+            * queue was full.
+            * @return The overflow count.
+            */
+            uint32_t getOverflowCount( void ) const noexcept;
+            /**
+            * @brief Get the total number of items sent to the queue.
+            * @return The number of items enqueued.
+            */
+            uint32_t getTotalEnqueued( void ) const noexcept;
+            /**
+            * @brief Clear the peak occupancy, the overflow count and the total
+            * of enqueued items.
+            */
+            void resetStats( void ) noexcept;
+        friend class task;
+    };
+
+    /**
+    * @brief A typed queue with compile-time capacity and in-object storage.
+    * @details The storage for the @a N items lives inside the object, so no
+    * setup is required. Items are copied with plain assignments of type
+    * @a T, so the compiler can use register moves for small items or a
+    * fixed-size copy for larger ones, and the ring indexes are wrapped with a
+    * mask instead of pointer comparisons. As it inherits from qOS::queue, a
+    * typed queue can be attached to a task with task::attachQueue().
+    *
+    * Example:
+    * @code{.c}
+    * struct sample_t {
+    *     uint16_t channel;
+    *     uint16_t value;
+    * };
+    * typedQueue<sample_t, 16> samples;
+    *
+    * void adcISR( void ) {
+    *     sample_t s = { ADC_CHANNEL, ADC_RESULT };
+    *     samples.send( s );
+    * }
+    * @endcode
+    * @pre @a T should be a trivially copyable type.
+    * @tparam T The type of the items.
+    * @tparam N The maximum number of items. Should be a power of two.
+    */
+    template <typename T, size_t N>
+    class typedQueue final : public queue {
+        static_assert( ( N > 0u ) && ( 0u == ( N & ( N - 1u ) ) ), "The typed queue length should be a power of two" );
+        private:
+            T items[ N ];
+            size_t rd{ 0u };
+            size_t wr{ 0u };
+            static const size_t MASK = N - 1u;
+            using queue::setup;
+            typedQueue( typedQueue const& ) = delete;
+            void operator=( typedQueue const& ) = delete;
+        public:
+            typedQueue() noexcept
+            {
+                (void)queue::setup( items, sizeof(T), N );
+            }
+            /**
+            * @brief Post an item to the queue by copy.
+            * @param[in] item The item to be placed on the queue.
+            * @param[in] pos Can take the value @c queueSendMode::TO_BACK (default)
+            * to place the item at the back of the queue, or @c queueSendMode::TO_FRONT
+            * to place the item at the front of the queue.
+            * @return @c true on successful add, @c false if the queue is full.
+            */
+            inline bool send( const T &item, const queueSendMode pos = queueSendMode::TO_BACK ) noexcept
+            {
+                bool retValue = false;
+
+                critical::enter();
+                if ( itemsWaiting < N ) {
+                    if ( queueSendMode::TO_FRONT == pos ) {
+                        --rd;
+                        items[ rd & MASK ] = item;
+                    }
+                    else {
+                        items[ wr & MASK ] = item;
+                        ++wr;
+                    }
+                    itemsWaiting = wr - rd;
+                    afterSend( 1u, 0u );
+                    retValue = true;
+                }
+                else {
+                    afterSend( 0u, 1u );
+                }
+                critical::exit();
+
+                return retValue;
+            }
+            /**
+            * @brief Receive an item from the queue (and removes it).
+            * @param[out] item The variable where the item will be copied.
+            * @return @c true if an item was received, otherwise returns @c false.
+            */
+            inline bool receive( T &item ) noexcept
+            {
+                bool retValue = false;
+
+                critical::enter();
+                if ( wr != rd ) {
+                    item = items[ rd & MASK ];
+                    ++rd;
+                    itemsWaiting = wr - rd;
+                    afterRemove();
+                    retValue = true;
+                }
+                critical::exit();
+
+                return retValue;
+            }
+            /** @brief See queue::send() */
+            bool send( void *itemToQueue, const queueSendMode pos = queueSendMode::TO_BACK ) noexcept override
+            {
+                /*cstat -CERT-EXP36-C_b*/
+                return ( nullptr != itemToQueue ) ? send( *static_cast<const T*>( itemToQueue ), pos ) : false;
+                /*cstat +CERT-EXP36-C_b*/
+            }
+            /** @brief See queue::receive() */
+            bool receive( void *dst ) noexcept override
+            {
+                /*cstat -CERT-EXP36-C_b*/
+                return ( nullptr != dst ) ? receive( *static_cast<T*>( dst ) ) : false;
+                /*cstat +CERT-EXP36-C_b*/
+            }
+            /** @brief See queue::peek() */
+            void* peek( void ) const noexcept override
+            {
+                const void *front = nullptr;
+
+                critical::enter();
+                if ( wr != rd ) {
+                    front = &items[ rd & MASK ];
+                }
+                critical::exit();
+
+                return const_cast<void*>( front );
+            }
+            /** @brief See queue::removeFront() */
+            bool removeFront( void ) noexcept override
+            {
+                bool retValue = false;
+
+                critical::enter();
+                if ( wr != rd ) {
+                    ++rd;
+                    itemsWaiting = wr - rd;
+                    afterRemove();
+                    retValue = true;
+                }
+                critical::exit();
+
+                return retValue;
+            }
+            /** @brief See queue::sendMany() */
+            size_t sendMany( const void *src, const size_t n ) noexcept override
+            {
+                size_t k = 0u;
+
+                if ( nullptr != src ) {
+                    critical::enter();
+                    k = N - ( wr - rd );
+                    k = ( n < k ) ? n : k;
+                    if ( k > 0u ) {
+                        const size_t w = wr & MASK;
+                        const size_t first = ( k < ( N - w ) ) ? k : ( N - w );
+                        /*cstat -CERT-EXP36-C_b*/
+                        const T * const s = static_cast<const T*>( src );
+                        /*cstat +CERT-EXP36-C_b*/
+                        (void)memcpy( &items[ w ], s, first*sizeof(T) );
+                        (void)memcpy( &items[ 0 ], &s[ first ], ( k - first )*sizeof(T) );
+                        wr += k;
+                        itemsWaiting = wr - rd;
+                    }
+                    afterSend( k, n - k );
+                    critical::exit();
+                }
+
+                return k;
+            }
+            /** @brief See queue::receiveMany() */
+            size_t receiveMany( void *dst, const size_t n ) noexcept override
+            {
+                size_t k = 0u;
+
+                if ( nullptr != dst ) {
+                    critical::enter();
+                    k = wr - rd;
+                    k = ( n < k ) ? n : k;
+                    if ( k > 0u ) {
+                        const size_t r = rd & MASK;
+                        const size_t first = ( k < ( N - r ) ) ? k : ( N - r );
+                        /*cstat -CERT-EXP36-C_b*/
+                        T * const d = static_cast<T*>( dst );
+                        /*cstat +CERT-EXP36-C_b*/
+                        (void)memcpy( d, &items[ r ], first*sizeof(T) );
+                        (void)memcpy( &d[ first ], &items[ 0 ], ( k - first )*sizeof(T) );
+                        rd += k;
+                        itemsWaiting = wr - rd;
+                        afterRemove();
+                    }
+                    critical::exit();
+                }
+
+                return k;
+            }
+            /** @brief See queue::reserve() */
+            void* reserve( size_t &n ) noexcept override
+            {
+                void *region = nullptr;
+                size_t k;
+                const size_t w = wr & MASK;
+
+                critical::enter();
+                k = N - ( wr - rd );
+                critical::exit();
+                k = ( k < ( N - w ) ) ? k : ( N - w );
+                n = ( n < k ) ? n : k;
+                if ( n > 0u ) {
+                    region = &items[ w ];
+                }
+
+                return region;
+            }
+            /** @brief See queue::commit() */
+            bool commit( const size_t n ) noexcept override
+            {
+                bool retValue = false;
+
+                critical::enter();
+                if ( ( n > 0u ) && ( n <= ( N - ( wr - rd ) ) ) ) {
+                    wr += n;
+                    itemsWaiting = wr - rd;
+                    afterSend( n, 0u );
+                    retValue = true;
+                }
+                critical::exit();
+
+                return retValue;
+            }
+            /** @brief See queue::peek( size_t& ) */
+            void* peek( size_t &n ) noexcept override
+            {
+                void *region = nullptr;
+                const size_t r = rd & MASK;
+
+                critical::enter();
+                n = wr - rd;
+                critical::exit();
+                n = ( n < ( N - r ) ) ? n : ( N - r );
+                if ( n > 0u ) {
+                    region = &items[ r ];
+                }
+
+                return region;
+            }
+            /** @brief See queue::release() */
+            bool release( const size_t n ) noexcept override
+            {
+                bool retValue = false;
+
+                critical::enter();
+                if ( ( n > 0u ) && ( n <= ( wr - rd ) ) ) {
+                    rd += n;
+                    itemsWaiting = wr - rd;
+                    afterRemove();
+                    retValue = true;
+                }
+                critical::exit();
+
+                return retValue;
+            }
+            /** @brief See queue::reset() */
+            void reset( void ) noexcept override
+            {
+                critical::enter();
+                rd = 0u;
+                wr = 0u;
+                itemsWaiting = 0u;
+                afterRemove();
+                critical::exit();
+            }
     };
 
     /** @}*/
@@ -0,0 +1,270 @@
+#ifndef QOS_CPP_CO_STACKFUL
+#define QOS_CPP_CO_STACKFUL
+
+#include "config/config.h"
+#include "include/types.hpp"
+#include "include/timer.hpp"
+#include "include/task.hpp"
+
+#ifndef Q_CO_STACKFUL
+    #define Q_CO_STACKFUL   ( 0 )
+#endif
+
+/*! @cond  */
+#if ( Q_CO_STACKFUL == 1 ) && !defined( ARDUINO_PLATFORM ) && ( defined( __unix__ ) || defined( __APPLE__ ) )
+    #define Q_CO_STACKFUL_AVAILABLE
+    #include <sys/ucontext.h>
+#endif
+/*! @endcond  */
+
+#if defined( Q_CO_STACKFUL_AVAILABLE )
+
+namespace qOS {
+
+    namespace co {
+
+        /** \addtogroup  qcoroutines
+        *  @{
+        */
+
+        /**
+        * @brief A pool of fixed-size stacks for stackful coroutines.
+        * @details The pool splits a user-supplied memory area in blocks of the
+        * same size. Stacks are taken by a co::stackful instance when it starts
+        * and given back when its function returns, so the number of coroutines
+        * can be larger than the number of stacks as long as they are not all
+        * alive at the same time.
+        */
+        class stackPool final {
+            private:
+                void *freeList{ nullptr };
+                size_t stackSize{ 0u };
+                size_t nFree{ 0u };
+                stackPool( stackPool const& ) = delete;
+                void operator=( stackPool const& ) = delete;
+            public:
+                stackPool() = default;
+                /**
+                * @brief Initializes the stack pool.
+                * @param[in] pArea A pointer to the memory area used to hold the
+                * stacks. The area should be statically allocated by the
+                * application writer.
+                * @param[in] areaSize The size in bytes of @a pArea.
+                * @param[in] sSize The size in bytes of every stack. This value
+                * will be rounded up to a multiple of 16 bytes.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setup( void *pArea, const size_t areaSize, const size_t sSize ) noexcept;
+                /**
+                * @brief Takes a stack from the pool.
+                * @return A pointer to the base of the stack or @c nullptr if
+                * there are no stacks left.
+                */
+                void* take( void ) noexcept;
+                /**
+                * @brief Returns a stack previously obtained with stackPool::take()
+                * @param[in] s The stack to be returned.
+                */
+                void give( void *s ) noexcept;
+                /**
+                * @brief Get the size of every stack inside the pool.
+                * @return The stack size in bytes.
+                */
+                size_t getStackSize( void ) const noexcept;
+                /**
+                * @brief Get the number of stacks that remain available.
+                * @return The number of free stacks.
+                */
+                size_t available( void ) const noexcept;
+        };
+
+        class stackful;
+
+        /**
+        * @brief Pointer to the function executed by a stackful coroutine
+        * @code{.c}
+        * void protocol( co::stackful &self, void *arg ) {
+        *     for ( ;; ) {
+        *         waitForFrame();
+        *         self.sleep( 100_ms );
+        *     }
+        * }
+        * @endcode
+        * @param self The stackful coroutine that runs the function.
+        * @param arg The user argument supplied in co::stackful::setup().
+        */
+        using stackfulFcn_t = void (*)( stackful&, void* );
+
+        /**
+        * @brief A stackful Co-Routine.
+        * @details Unlike the co::reenter() segments, a stackful coroutine owns a
+        * private stack, so local variables survive a yield and blocking calls
+        * can be made from any nested function. Every instance keeps its own
+        * context, so a single function can drive any number of instances.
+        * The coroutine runs only inside stackful::resume(), which is usually
+        * called from a task callback.
+        *
+        * Example :
+        * @code{.c}
+        * static uint8_t stackArea[ 4*4096 ];
+        * co::stackPool stacks;
+        * co::stackful link1, link2;
+        *
+        * void linkProtocol( co::stackful &self, void *arg ) {
+        *     int retries = 0;
+        *     for ( ;; ) {
+        *         self.waitFor( [arg]() { return frameAvailable( arg ); } );
+        *         ++retries;
+        *         self.sleep( 10_ms );
+        *     }
+        * }
+        *
+        * void main( void ) {
+        *     stacks.setup( stackArea, sizeof(stackArea), 4096u );
+        *     link1.setup( linkProtocol, &port1, stacks );
+        *     link2.setup( linkProtocol, &port2, stacks );
+        *     os.addTask( t1, co::stackful::taskCallback, core::LOWEST_PRIORITY, 1_ms, task::PERIODIC, taskState::ENABLED_STATE, &link1 );
+        *     os.addTask( t2, co::stackful::taskCallback, core::LOWEST_PRIORITY, 1_ms, task::PERIODIC, taskState::ENABLED_STATE, &link2 );
+        * }
+        * @endcode
+        * @note Only available on hosted POSIX builds. See @c Q_CO_STACKFUL.
+        * @note Every switch saves and restores the whole ucontext, including
+        * the signal mask, so a suspend/resume round-trip is far more expensive
+        * than a co::yield(). Use check/co_switch_bench.cpp to compare both on
+        * the target host.
+        */
+        class stackful final {
+            private:
+                ucontext_t ctx;
+                ucontext_t caller;
+                stackfulFcn_t fcn{ nullptr };
+                void *arg{ nullptr };
+                stackPool *pool{ nullptr };
+                void *stack{ nullptr };
+                size_t stackSize{ 0u };
+                qOS::timer tm;
+                uint8_t status{ 0u };
+                bool prepare( void ) noexcept;
+                void releaseStack( void ) noexcept;
+                static void entryPoint( void );
+                static stackful *running; // skipcq: CXX-W2009
+                stackful( stackful const& ) = delete;
+                void operator=( stackful const& ) = delete;
+            public:
+                stackful() = default;
+                ~stackful();
+                /**
+                * @brief Setup the stackful coroutine using a stack from a pool.
+                * The stack is taken on the first resume and given back to the
+                * pool when the coroutine function returns.
+                * @param[in] f The coroutine function.
+                * @param[in] a The user argument passed to @a f
+                * @param[in] p The pool from where the stack will be taken.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setup( stackfulFcn_t f, void *a, stackPool &p ) noexcept;
+                /**
+                * @brief Setup the stackful coroutine using a dedicated stack.
+                * @param[in] f The coroutine function.
+                * @param[in] a The user argument passed to @a f
+                * @param[in] pStack The memory area used as stack.
+                * @param[in] sSize The size in bytes of @a pStack
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool setup( stackfulFcn_t f, void *a, void *pStack, const size_t sSize ) noexcept;
+                /**
+                * @brief Run the coroutine until it yields or its function
+                * returns.
+                * @note Resuming a coroutine from inside another stackful
+                * coroutine is not allowed.
+                * @return @c true if the coroutine can be resumed again, @c false
+                * if the coroutine has finished, is not configured or there
+                * are no stacks available in the pool.
+                */
+                bool resume( void ) noexcept;
+                /**
+                * @brief Return the control back to the caller of
+                * stackful::resume(). The execution continues after this call
+                * on the next resume.
+                * @pre Should only be called from the coroutine itself.
+                */
+                void suspend( void ) noexcept;
+                /**
+                * @brief Yields until the specified time has elapsed.
+                * @pre Should only be called from the coroutine itself.
+                * @param[in] t The amount of time to wait.
+                */
+                void sleep( const qOS::duration_t t ) noexcept;
+                /**
+                * @brief Yields until the supplied condition is met.
+                * @pre Should only be called from the coroutine itself.
+                * @param[in] condition A callable object returning a @c bool.
+                */
+                template <typename Condition>
+                inline void waitFor( Condition condition )
+                {
+                    while ( !condition() ) {
+                        suspend();
+                    }
+                }
+                /**
+                * @brief Yields until the supplied condition is met or the
+                * specified timeout expires.
+                * @pre Should only be called from the coroutine itself.
+                * @param[in] condition A callable object returning a @c bool.
+                * @param[in] timeout The maximum amount of time to wait.
+                * @return @c true if the condition was met, @c false if the
+                * timeout expired.
+                */
+                template <typename Condition>
+                inline bool waitFor( Condition condition, const qOS::duration_t timeout )
+                {
+                    bool retValue;
+
+                    (void)tm.set( timeout );
+                    while ( false == ( retValue = condition() ) ) {
+                        if ( tm.expired() ) {
+                            break;
+                        }
+                        suspend();
+                    }
+                    tm.disarm();
+
+                    return retValue;
+                }
+                /**
+                * @brief Restart the coroutine, so the next resume will call the
+                * coroutine function from the beginning.
+                * @warning Objects living in the coroutine stack are discarded
+                * without calling their destructors.
+                * @pre Should not be called from the coroutine itself.
+                * @return @c true on success, otherwise returns @c false.
+                */
+                bool reset( void ) noexcept;
+                /**
+                * @brief Check if the coroutine function has not returned yet.
+                * @return @c true if the coroutine is alive, otherwise returns
+                * @c false.
+                */
+                bool isAlive( void ) const noexcept;
+                /**
+                * @brief Get the stackful coroutine currently running.
+                * @return A pointer to the running coroutine or @c nullptr if
+                * called outside a stackful coroutine.
+                */
+                static stackful* self( void ) noexcept;
+                /**
+                * @brief A task callback that resumes the stackful coroutine
+                * passed as task argument (event_t::TaskData).
+                * @param[in] e The task event information.
+                */
+                static void taskCallback( event_t e );
+        };
+
+        /** @}*/
+    }
+}
+
+#endif /*Q_CO_STACKFUL_AVAILABLE*/
+
+#endif /*QOS_CPP_CO_STACKFUL*/
@@ -0,0 +1,664 @@
+#ifndef QOS_CPP_STATIC_FSM
+#define QOS_CPP_STATIC_FSM
+
+#include "config/config.h"
+#include "include/types.hpp"
+#include "include/timer.hpp"
+#include "include/queue.hpp"
+#include "include/task.hpp"
+#include "include/fsm.hpp"
+
+namespace qOS {
+
+    namespace sm {
+
+        /** @addtogroup  qfsm
+         *  @{
+         */
+
+        /**
+        * @brief The identifier used by the static state machines to refer to
+        * the top state ( the parent of the outermost states ).
+        */
+        constexpr size_t TOP_STATE = 0xFFFFu;
+        /**
+        * @brief The identifier used by the static state machines to indicate
+        * that there is no state. Used as the default initial child of a state.
+        */
+        constexpr size_t NO_STATE = 0xFFFEu;
+
+        /**
+        * @brief Pointer to the callback of a state inside a static state
+        * machine.
+        * @note The built-in signals sm::signalID::SIGNAL_ENTRY and
+        * sm::signalID::SIGNAL_EXIT are delivered when the state is entered and
+        * exited.
+        * @param sig The signal being processed.
+        * @return The state status. Return sm::status::SIGNAL_HANDLED to stop
+        * the propagation of the signal to the parent states.
+        */
+        using staticCallback_t = sm::status (*)( const sm::signal_t &sig );
+
+        /**
+        * @brief Pointer to the guard (and action) of a transition inside a
+        * static state machine.
+        * @param sig The signal that triggered the transition.
+        * @return @c true to allow the transition, otherwise @c false.
+        */
+        using staticGuard_t = bool (*)( const sm::signal_t &sig );
+
+        /**
+        * @brief Defines a state of a static state machine.
+        * @tparam Id The state identifier. Should be unique inside the machine.
+        * @tparam Parent The identifier of the parent state or sm::TOP_STATE
+        * @tparam Fcn The state callback. Can be @c nullptr
+        * @tparam Init The initial child state (default transition) if this is
+        * a composite state, otherwise sm::NO_STATE
+        */
+        template <size_t Id, size_t Parent, staticCallback_t Fcn, size_t Init = NO_STATE>
+        struct stateOf {
+            /*! @cond */
+            static constexpr size_t id( void ) { return Id; }
+            static constexpr size_t parent( void ) { return Parent; }
+            static constexpr size_t init( void ) { return Init; }
+            static inline sm::status call( const sm::signal_t &sig )
+            {
+                /*cstat -MISRAC++2008-5-0-3*/
+                return ( nullptr != Fcn ) ? Fcn( sig ) : sm::status::ABSENT;
+                /*cstat +MISRAC++2008-5-0-3*/
+            }
+            /*! @endcond */
+        };
+
+        /**
+        * @brief Defines a transition of a static state machine.
+        * @tparam From The source state. The transition is also taken when the
+        * signal reaches @a From while one of its children is active.
+        * @tparam Sig The signal that triggers the transition.
+        * @tparam To The target state.
+        * @tparam Guard An optional guard. Can be used to perform the transition
+        * action.
+        */
+        template <size_t From, signalID Sig, size_t To, staticGuard_t Guard = nullptr>
+        struct transitionOf {
+            /*! @cond */
+            static constexpr size_t from( void ) { return From; }
+            static constexpr signalID sig( void ) { return Sig; }
+            static constexpr size_t to( void ) { return To; }
+            static inline bool allowed( const sm::signal_t &s )
+            {
+                return ( nullptr == Guard ) || Guard( s );
+            }
+            /*! @endcond */
+        };
+
+        /**
+        * @brief Defines a timeout of a static state machine. The timeout is
+        * set when the state is entered and stopped when the state is exited.
+        * On expiration, the signal sm::SIGNAL_TIMEOUT( @a Index ) is sent. If
+        * the state is exited while that signal is still queued, the signal is
+        * discarded.
+        * @tparam State The state that owns the timeout.
+        * @tparam Index The timeout index (0, 1, 2 ... ( @c Q_FSM_MAX_TIMEOUTS-1 ) )
+        * @tparam Time The timeout value.
+        * @tparam Periodic If @c true, the timeout is reloaded after every
+        * expiration while the state is active.
+        */
+        template <size_t State, index_t Index, qOS::duration_t Time, bool Periodic = false>
+        struct timeoutOf {
+            /*! @cond */
+            static constexpr size_t state( void ) { return State; }
+            static constexpr index_t index( void ) { return Index; }
+            static constexpr qOS::duration_t time( void ) { return Time; }
+            static constexpr bool periodic( void ) { return Periodic; }
+            static_assert( Index < static_cast<index_t>( Q_FSM_MAX_TIMEOUTS ), "Timeout index out of range, check Q_FSM_MAX_TIMEOUTS" );
+            /*! @endcond */
+        };
+
+        /**
+        * @brief The list of states of a static state machine.
+        * @tparam S A list of sm::stateOf definitions.
+        */
+        template <typename... S>
+        struct states {};
+
+        /**
+        * @brief The list of transitions of a static state machine.
+        * @tparam T A list of sm::transitionOf definitions.
+        */
+        template <typename... T>
+        struct transitions {};
+
+        /**
+        * @brief The list of timeouts of a static state machine.
+        * @tparam K A list of sm::timeoutOf definitions.
+        */
+        template <typename... K>
+        struct timeouts {};
+
+        /*! @cond */
+        namespace staticImpl {
+
+            template <typename... S>
+            struct stateTable;
+
+            template <>
+            struct stateTable<> {
+                static constexpr bool exists( const size_t id ) { return ( TOP_STATE == id ); }
+                static constexpr size_t parent( const size_t ) { return NO_STATE; }
+                static constexpr size_t init( const size_t ) { return NO_STATE; }
+                static constexpr size_t count( const size_t ) { return 0u; }
+                template <typename Root>
+                static constexpr bool parentsValid( void ) { return true; }
+                template <typename Root>
+                static constexpr bool initsValid( void ) { return true; }
+                template <typename Root>
+                static constexpr size_t maxDepth( void ) { return 0u; }
+                template <typename Root, typename Tr>
+                static constexpr bool hasReachableChild( const size_t, const size_t ) { return false; }
+                template <typename Root, typename Tr>
+                static constexpr bool allReachable( void ) { return true; }
+                static inline sm::status call( const size_t, const sm::signal_t& ) { return sm::status::ABSENT; }
+            };
+
+            template <typename H, typename... R>
+            struct stateTable<H, R...> {
+                using next = stateTable<R...>;
+                static constexpr bool exists( const size_t id )
+                {
+                    return ( H::id() == id ) || next::exists( id );
+                }
+                static constexpr size_t parent( const size_t id )
+                {
+                    return ( H::id() == id ) ? H::parent() : next::parent( id );
+                }
+                static constexpr size_t init( const size_t id )
+                {
+                    return ( H::id() == id ) ? H::init() : next::init( id );
+                }
+                static constexpr size_t count( const size_t id )
+                {
+                    return ( ( H::id() == id ) ? 1u : 0u ) + next::count( id );
+                }
+                template <typename Root>
+                static constexpr bool parentsValid( void )
+                {
+                    return ( H::id() < NO_STATE ) && ( 1u == Root::count( H::id() ) ) && Root::exists( H::parent() ) && next::template parentsValid<Root>();
+                }
+                template <typename Root>
+                static constexpr bool initsValid( void )
+                {
+                    return ( ( NO_STATE == H::init() ) || ( H::id() == Root::parent( H::init() ) ) ) && next::template initsValid<Root>();
+                }
+                template <typename Root>
+                static constexpr size_t maxDepth( void )
+                {
+                    return ( Root::depth( H::id(), 0u ) > next::template maxDepth<Root>() ) ? Root::depth( H::id(), 0u ) : next::template maxDepth<Root>();
+                }
+                template <typename Root, typename Tr>
+                static constexpr bool hasReachableChild( const size_t id, const size_t n )
+                {
+                    return ( ( id == H::parent() ) && Root::template reachable<Tr>( H::id(), n + 1u ) ) || next::template hasReachableChild<Root, Tr>( id, n );
+                }
+                template <typename Root, typename Tr>
+                static constexpr bool allReachable( void )
+                {
+                    return Root::template reachable<Tr>( H::id(), 0u ) && next::template allReachable<Root, Tr>();
+                }
+                static inline sm::status call( const size_t id, const sm::signal_t &sig )
+                {
+                    return ( H::id() == id ) ? H::call( sig ) : next::call( id, sig );
+                }
+            };
+
+            template <typename... T>
+            struct transitionTable;
+
+            template <>
+            struct transitionTable<> {
+                template <typename S>
+                static constexpr bool statesValid( void ) { return true; }
+                static constexpr bool isTarget( const size_t ) { return false; }
+                static inline size_t find( const size_t, const sm::signal_t& ) { return NO_STATE; }
+            };
+
+            template <typename H, typename... R>
+            struct transitionTable<H, R...> {
+                using next = transitionTable<R...>;
+                template <typename S>
+                static constexpr bool statesValid( void )
+                {
+                    return S::exists( H::from() ) && S::exists( H::to() ) && ( TOP_STATE != H::to() ) && next::template statesValid<S>();
+                }
+                static constexpr bool isTarget( const size_t id )
+                {
+                    return ( H::to() == id ) || next::isTarget( id );
+                }
+                static inline size_t find( const size_t from, const sm::signal_t &sig )
+                {
+                    return ( ( H::from() == from ) && ( H::sig() == sig.id ) && H::allowed( sig ) ) ? H::to() : next::find( from, sig );
+                }
+            };
+
+            template <typename... K>
+            struct timeoutTable;
+
+            template <>
+            struct timeoutTable<> {
+                static inline void enter( timer*, uint32_t&, const size_t ) {}
+                static inline void exit( timer*, size_t*, const size_t*, const size_t ) {}
+            };
+
+            template <typename H, typename... R>
+            struct timeoutTable<H, R...> {
+                using next = timeoutTable<R...>;
+                static inline void enter( timer *tm, uint32_t &periodic, const size_t id )
+                {
+                    if ( H::state() == id ) {
+                        (void)tm[ H::index() ].set( H::time() );
+                        if ( H::periodic() ) {
+                            periodic |= ( static_cast<uint32_t>( 1u ) << H::index() );
+                        }
+                        else {
+                            periodic &= ~( static_cast<uint32_t>( 1u ) << H::index() );
+                        }
+                    }
+                    next::enter( tm, periodic, id );
+                }
+                static inline void exit( timer *tm, size_t *cancelled, const size_t *pending, const size_t id )
+                {
+                    if ( H::state() == id ) {
+                        /*the signals already queued are discarded when they are dequeued*/
+                        cancelled[ H::index() ] = pending[ H::index() ];
+                        tm[ H::index() ].disarm();
+                    }
+                    next::exit( tm, cancelled, pending, id );
+                }
+            };
+
+        }
+        /*! @endcond */
+
+        /*! @cond */
+        template <size_t Init, typename S, typename T, typename K = timeouts<>>
+        class staticMachine;
+        /*! @endcond */
+
+        /**
+        * @brief A state machine whose topology, transitions and timeouts are
+        * fully defined at compile time.
+        * @details The definition is written with the sm::states,
+        * sm::transitions and sm::timeouts lists. The compiler generates the
+        * dispatch code from them, so there is no runtime setup, no virtual
+        * calls and no function pointers stored in RAM: every state callback,
+        * guard and timeout is resolved statically. The definition is checked
+        * at compile time for:
+        * - Unique state identifiers and valid parent states.
+        * - Initial children that are not direct children of their state.
+        * - Transitions referencing states that do not exist.
+        * - A nesting deeper than @c Q_FSM_MAX_NEST_DEPTH
+        * - States that are never entered, i.e. states that are not the initial
+        * state, a transition target or a default child, and that do not have
+        * such a descendant.
+        *
+        * The runtime engine ( qOS::stateMachine ) is still available for
+        * topologies that should change at runtime or need history
+        * pseudo-states.
+        *
+        * Example:
+        * @code{.c}
+        * enum : size_t { IDLE, RUN, RUN_SLOW, RUN_FAST };
+        * const sm::signalID SIG_START = sm::SIGNAL_USER( 1u );
+        * const sm::signalID SIG_STOP = sm::SIGNAL_USER( 2u );
+        * const sm::signalID SIG_BOOST = sm::SIGNAL_USER( 3u );
+        *
+        * using motor_t = sm::staticMachine< IDLE,
+        *     sm::states<
+        *         sm::stateOf< IDLE, sm::TOP_STATE, idleState >,
+        *         sm::stateOf< RUN, sm::TOP_STATE, runState, RUN_SLOW >,
+        *         sm::stateOf< RUN_SLOW, RUN, slowState >,
+        *         sm::stateOf< RUN_FAST, RUN, fastState >
+        *     >,
+        *     sm::transitions<
+        *         sm::transitionOf< IDLE, SIG_START, RUN >,
+        *         sm::transitionOf< RUN, SIG_STOP, IDLE >,
+        *         sm::transitionOf< RUN_SLOW, SIG_BOOST, RUN_FAST, batteryOk >,
+        *         sm::transitionOf< RUN_FAST, sm::SIGNAL_TIMEOUT( 0 ), RUN_SLOW >
+        *     >,
+        *     sm::timeouts<
+        *         sm::timeoutOf< RUN_FAST, 0, 5_sec >
+        *     >
+        * >;
+        *
+        * motor_t motor;
+        * os.addTask( motorTask, motor_t::taskCallback, core::MEDIUM_PRIORITY, 10_ms, task::PERIODIC, taskState::ENABLED_STATE, &motor );
+        * @endcode
+        * @tparam Init The initial state.
+        * @tparam S The list of states ( sm::states )
+        * @tparam T The list of transitions ( sm::transitions )
+        * @tparam K The list of timeouts ( sm::timeouts ). Optional.
+        */
+        template <size_t Init, typename... S, typename... T, typename... K>
+        class staticMachine<Init, states<S...>, transitions<T...>, timeouts<K...>> final {
+            private:
+                using stateTbl = staticImpl::stateTable<S...>;
+                using transitionTbl = staticImpl::transitionTable<T...>;
+                using timeoutTbl = staticImpl::timeoutTable<K...>;
+                struct model {
+                    static constexpr bool exists( const size_t id ) { return stateTbl::exists( id ); }
+                    static constexpr size_t parent( const size_t id ) { return stateTbl::parent( id ); }
+                    static constexpr size_t count( const size_t id ) { return stateTbl::count( id ); }
+                    static constexpr size_t depth( const size_t id, const size_t n )
+                    {
+                        /*the guard on n stops the recursion on a cyclic hierarchy*/
+                        return ( ( TOP_STATE == id ) || ( NO_STATE == id ) || ( n > 255u ) ) ? 0u : ( 1u + depth( stateTbl::parent( id ), n + 1u ) );
+                    }
+                    template <typename Tr>
+                    static constexpr bool reachable( const size_t id, const size_t n )
+                    {
+                        return ( n <= 255u ) && ( ( Init == id ) || Tr::isTarget( id ) || ( stateTbl::init( stateTbl::parent( id ) ) == id ) || stateTbl::template hasReachableChild<model, Tr>( id, n ) );
+                    }
+                };
+                static_assert( sizeof...( S ) > 0u, "A static state machine should have at least one state" );
+                static_assert( stateTbl::template parentsValid<model>(), "Duplicated state identifier or parent state not defined" );
+                static_assert( stateTbl::template initsValid<model>(), "The initial state of a composite state should be one of its children" );
+                static_assert( stateTbl::exists( Init ) && ( TOP_STATE != Init ), "The initial state is not defined" );
+                static_assert( transitionTbl::template statesValid<stateTbl>(), "A transition references an undefined state" );
+                static_assert( stateTbl::template maxDepth<model>() <= static_cast<size_t>( Q_FSM_MAX_NEST_DEPTH ) - 1u, "The nesting depth exceeds Q_FSM_MAX_NEST_DEPTH" );
+                static_assert( stateTbl::template allReachable<model, transitionTbl>(), "The state machine has states that are never entered" );
+
+                size_t current{ NO_STATE };
+                sm::signal_t signalNot;
+                queue *sQueue{ nullptr };
+                timer tm[ Q_FSM_MAX_TIMEOUTS ];
+                uint32_t isPeriodic{ 0u };
+                size_t pending[ Q_FSM_MAX_TIMEOUTS ] = { 0u };
+                size_t cancelled[ Q_FSM_MAX_TIMEOUTS ] = { 0u };
+                staticMachine( staticMachine const& ) = delete;
+                void operator=( staticMachine const& ) = delete;
+
+                void enter( const size_t id ) noexcept
+                {
+                    sm::signal_t sig;
+
+                    sig.id = sm::signalID::SIGNAL_ENTRY;
+                    (void)stateTbl::call( id, sig );
+                    timeoutTbl::enter( tm, isPeriodic, id );
+                    current = id;
+                }
+                void exit( const size_t id ) noexcept
+                {
+                    sm::signal_t sig;
+
+                    sig.id = sm::signalID::SIGNAL_EXIT;
+                    (void)stateTbl::call( id, sig );
+                    timeoutTbl::exit( tm, cancelled, pending, id );
+                    current = stateTbl::parent( id );
+                }
+                void enterFrom( const size_t lca, const size_t target ) noexcept
+                {
+                    if ( ( target != lca ) && ( TOP_STATE != target ) ) {
+                        enterFrom( lca, stateTbl::parent( target ) );
+                        enter( target );
+                    }
+                }
+                void enterDefaults( void ) noexcept
+                {
+                    while ( NO_STATE != stateTbl::init( current ) ) {
+                        enter( stateTbl::init( current ) );
+                    }
+                }
+                void transition( const size_t source, const size_t target ) noexcept
+                {
+                    size_t s = source;
+                    size_t t = target;
+
+                    while ( current != source ) {
+                        exit( current );
+                    }
+                    if ( source == target ) {
+                        exit( source ); /*self-transition*/
+                        t = stateTbl::parent( target );
+                    }
+                    else {
+                        size_t ds = model::depth( s, 0u );
+                        size_t dt = model::depth( t, 0u );
+
+                        while ( ds > dt ) {
+                            s = stateTbl::parent( s );
+                            --ds;
+                        }
+                        while ( dt > ds ) {
+                            t = stateTbl::parent( t );
+                            --dt;
+                        }
+                        while ( s != t ) {
+                            s = stateTbl::parent( s );
+                            t = stateTbl::parent( t );
+                        }
+                        /*exit up to the LCA, an ancestor target is not re-entered*/
+                        while ( ( current != t ) && ( TOP_STATE != current ) ) {
+                            exit( current );
+                        }
+                    }
+                    enterFrom( t, target );
+                    enterDefaults();
+                }
+                bool signalSend( const sm::signalID sig, void *sData, const bool isUrgent ) noexcept
+                {
+                    bool retValue = false;
+                    #if ( Q_QUEUES == 1 )
+                        if ( nullptr != sQueue ) {
+                            sm::signal_t msg;
+
+                            msg.id = sig;
+                            msg.data = sData;
+                            retValue = sQueue->send( &msg, isUrgent ? queueSendMode::TO_FRONT : queueSendMode::TO_BACK );
+                        }
+                    #else
+                        Q_UNUSED( isUrgent );
+                    #endif
+                    if ( ( false == retValue ) && ( sm::signalID::SIGNAL_NONE == signalNot.id ) ) {
+                        signalNot.id = sig;
+                        signalNot.data = sData;
+                        retValue = true;
+                    }
+
+                    return retValue;
+                }
+                bool timeoutDiscard( const sm::signalID id ) noexcept
+                {
+                    bool retValue = false;
+
+                    if ( ( id >= sm::signalID::TM_MIN ) && ( id <= sm::signalID::TM_MAX ) ) {
+                        const size_t i = static_cast<size_t>( id - sm::signalID::TM_MIN );
+
+                        if ( pending[ i ] > 0u ) {
+                            --pending[ i ];
+                        }
+                        if ( cancelled[ i ] > 0u ) {
+                            --cancelled[ i ];
+                            retValue = true;
+                        }
+                    }
+
+                    return retValue;
+                }
+                void timeoutResync( void ) noexcept
+                {
+                    for ( size_t i = 0u ; i < static_cast<size_t>( Q_FSM_MAX_TIMEOUTS ) ; ++i ) {
+                        pending[ i ] = 0u;
+                        cancelled[ i ] = 0u;
+                    }
+                }
+                sm::signal_t checkForSignals( const sm::signal_t sig ) noexcept
+                {
+                    sm::signal_t xSignal = sig;
+                    bool drained;
+
+                    for ( index_t i = 0u ; i < static_cast<index_t>( Q_FSM_MAX_TIMEOUTS ) ; ++i ) {
+                        if ( tm[ i ].expired() ) {
+                            if ( signalSend( sm::SIGNAL_TIMEOUT( i ), nullptr, false ) ) {
+                                ++pending[ i ];
+                            }
+                            if ( 0u != ( isPeriodic & ( static_cast<uint32_t>( 1u ) << i ) ) ) {
+                                tm[ i ].reload();
+                            }
+                            else {
+                                tm[ i ].disarm();
+                            }
+                        }
+                    }
+                    #if ( Q_QUEUES == 1 )
+                        if ( nullptr != sQueue ) {
+                            sm::signal_t receivedSignal;
+
+                            while ( sQueue->receive( &receivedSignal ) ) {
+                                if ( false == timeoutDiscard( receivedSignal.id ) ) {
+                                    xSignal = receivedSignal;
+                                    break;
+                                }
+                            }
+                        }
+                    #endif
+                    if ( ( sm::signalID::SIGNAL_NONE == xSignal.id ) && ( sm::signalID::SIGNAL_NONE != signalNot.id ) ) {
+                        if ( false == timeoutDiscard( signalNot.id ) ) {
+                            xSignal = signalNot;
+                        }
+                        signalNot.id = sm::signalID::SIGNAL_NONE;
+                        signalNot.data = nullptr;
+                    }
+                    /*nothing left to dispatch, so no timeout signal can be pending*/
+                    drained = ( sm::signalID::SIGNAL_NONE == signalNot.id );
+                    #if ( Q_QUEUES == 1 )
+                        drained = drained && ( ( nullptr == sQueue ) || ( 0u == sQueue->count() ) );
+                    #endif
+                    if ( drained ) {
+                        timeoutResync();
+                    }
+
+                    return xSignal;
+                }
+            public:
+                staticMachine() = default;
+                /**
+                * @brief Install a signal queue. Without a queue, a single
+                * signal can be pending at a time.
+                * @attention Queue item size = sizeof( @ref sm::signal_t )
+                * @param[in] q The queue to be installed.
+                * @return @c true on success, otherwise return @c false.
+                */
+                bool installSignalQueue( queue &q ) noexcept
+                {
+                    bool retValue = false;
+
+                    if ( q.isInitialized() && ( sizeof(sm::signal_t) == q.getItemSize() ) ) {
+                        sQueue = &q;
+                        timeoutResync(); /*the queued timeout signals are not known*/
+                        retValue = true;
+                    }
+
+                    return retValue;
+                }
+                /**
+                * @brief Sends a signal to the state machine.
+                * @see stateMachine::sendSignal()
+                * @param[in] sig The user-defined signal. Timeout signals are
+                * only sent by the state machine itself and are rejected.
+                * @param[in] sData The data associated to the signal.
+                * @param[in] isUrgent If true, the signal will be sent to the
+                * front of the signal queue.
+                * @return @c true if the signal was delivered, otherwise returns
+                * @c false.
+                */
+                bool sendSignal( const sm::signalID sig, void *sData = nullptr, const bool isUrgent = false ) noexcept
+                {
+                    bool retValue = false;
+
+                    /*timeout signals are only sent by the engine*/
+                    if ( sig < sm::signalID::TM_MIN ) {
+                        retValue = signalSend( sig, sData, isUrgent );
+                    }
+
+                    return retValue;
+                }
+                /**
+                * @brief Execute the state machine with the next available
+                * signal. The first call enters the initial state.
+                * @param[in] sig User-defined signal (ignored if there is a
+                * signal pending).
+                * @return @c true if the signal was handled, otherwise returns
+                * @c false.
+                */
+                bool run( const sm::signal_t sig = sm::signal_t() ) noexcept
+                {
+                    bool retValue = false;
+                    const sm::signal_t xSignal = checkForSignals( sig );
+
+                    if ( NO_STATE == current ) {
+                        current = TOP_STATE;
+                        enterFrom( TOP_STATE, Init );
+                        enterDefaults();
+                    }
+                    for ( size_t s = current ; TOP_STATE != s ; s = stateTbl::parent( s ) ) {
+                        const size_t target = transitionTbl::find( s, xSignal );
+
+                        if ( NO_STATE != target ) {
+                            transition( s, target );
+                            retValue = true;
+                            break;
+                        }
+                        if ( sm::status::SIGNAL_HANDLED == stateTbl::call( s, xSignal ) ) {
+                            retValue = true;
+                            break;
+                        }
+                    }
+
+                    return retValue;
+                }
+                /**
+                * @brief Get the innermost active state.
+                * @return The identifier of the current state or sm::NO_STATE if
+                * the machine has not been started.
+                */
+                inline size_t getCurrent( void ) const noexcept
+                {
+                    return current;
+                }
+                /**
+                * @brief Check if a state is active, either as the current state
+                * or as one of its ancestors.
+                * @param[in] id The state identifier.
+                * @return @c true if the state is active, otherwise @c false.
+                */
+                bool isIn( const size_t id ) const noexcept
+                {
+                    size_t s = current;
+
+                    while ( ( TOP_STATE != s ) && ( NO_STATE != s ) && ( id != s ) ) {
+                        s = stateTbl::parent( s );
+                    }
+
+                    return ( id == s );
+                }
+                /**
+                * @brief The task callback that drives the static state machine
+                * passed as task argument (event_t::TaskData).
+                * @param[in] e The task event information.
+                */
+                static void taskCallback( event_t e )
+                {
+                    /*cstat -CERT-EXP36-C_b*/
+                    staticMachine * const m = static_cast<staticMachine*>( e.TaskData );
+                    /*cstat +CERT-EXP36-C_b*/
+                    if ( nullptr != m ) {
+                        (void)m->run();
+                    }
+                }
+        };
+
+        /** @}*/
+    }
+}
+
+#endif /*QOS_CPP_STATIC_FSM*/
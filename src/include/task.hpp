@@ -77,7 +77,19 @@ namespace qOS {
         /**
         * @brief Only available when the Idle Task is triggered.
         */
-        byNoReadyTasks
+        byNoReadyTasks,
+        /**
+        * @brief When the number of items in the attached queue rises to its
+        * high watermark. A pointer to the queue will be available in the
+        * event_t::EventData field.
+        */
+        byQueueHighWatermark,
+        /**
+        * @brief When the number of items in the attached queue falls back to
+        * its low watermark. A pointer to the queue will be available in the
+        * event_t::EventData field.
+        */
+        byQueueLowWatermark
     };
 
     /**
@@ -93,6 +105,10 @@ namespace qOS {
 
     /*! @cond  */
     class task;
+    namespace co {
+        class _waitQueue;
+        void _waitCancel( task &t ) noexcept;
+    }
     /*! @endcond  */
 
 
@@ -278,6 +294,7 @@ namespace qOS {
         QUEUE_FULL = 8u,        /**< This mode will trigger the task if the queue is full. A pointer to the queue will be available in the event_t::EventData field.*/
         QUEUE_COUNT = 16u,      /**< This mode will trigger the task if the count of elements in the queue reach the specified value. A pointer to the queue will be available in the event_t::EventData field.*/
         QUEUE_EMPTY = 32u,      /**< This mode will trigger the task if the queue is empty. A pointer to the queue will be available in the event_t::EventData field.*/
+        QUEUE_WATERMARKS = 1024u, /**< This mode will trigger the task when the queue crosses its high or low watermark. See queue::setWatermarks(). A pointer to the queue will be available in the event_t::EventData field.*/
     };
 
     /**
@@ -344,6 +361,8 @@ namespace qOS {
     */
     class task : protected node {
         friend class core;
+        friend class co::_waitQueue;
+        friend class queue;
         private:
             void *taskData{ nullptr };
             void *asyncData{ nullptr };
@@ -360,10 +379,15 @@ namespace qOS {
             volatile taskFlag_t flags{ 0uL };
             priority_t priority{ 0u };
             trigger Trigger{ trigger::None };
+            task *wNext{ nullptr };
+            void *wObj{ nullptr };
+            volatile uint8_t wmEdges{ 0u };
+            bool wmRising{ false };
             void setFlags( const uint32_t xFlags, const bool value ) noexcept;
             bool getFlag( const uint32_t flag ) const noexcept;
             bool deadLineReached( void ) const noexcept;
             trigger queueCheckEvents( void ) noexcept;
+            void watermarkEdge( const bool rising ) noexcept;
             static _Event * pEventInfo; // skipcq: CXX-W2011, CXX-W2009
             static const uint32_t BIT_INIT;
             static const uint32_t BIT_ENABLED;
@@ -371,8 +395,11 @@ namespace qOS {
             static const uint32_t BIT_QUEUE_FULL;
             static const uint32_t BIT_QUEUE_COUNT;
             static const uint32_t BIT_QUEUE_EMPTY;
+            static const uint32_t BIT_QUEUE_WATERMARKS;
             static const uint32_t BIT_SHUTDOWN;
             static const uint32_t BIT_REMOVE_REQUEST;
+            static const uint32_t BIT_WAIT_GRANTED;
+            static const uint32_t BIT_WAIT_ENABLED;
             static const uint32_t EVENT_FLAGS_MASK;
             static const uint32_t QUEUE_FLAGS_MASK;
             task( task const& ) = delete;
@@ -565,6 +592,11 @@ namespace qOS {
             * queueLinkMode::QUEUE_EMPTY : The task will be triggered if the queue
             * is empty. A pointer to the queue will be available in the
             * event_t::EventData field.
+            *
+            * queueLinkMode::QUEUE_WATERMARKS : The task will be triggered once
+            * every time the queue crosses its high or low watermark. See
+            * queue::setWatermarks(). A pointer to the queue will be available
+            * in the event_t::EventData field.
             * @param[in] arg This argument defines if the queue will be attached
             * (1u) or detached (0u) from the task.
             * If the queueLinkMode::QUEUE_COUNT mode is specified, this value
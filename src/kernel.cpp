@@ -78,6 +78,13 @@ static void fsmTaskCallback( event_t e )
 } 
 /*cstat +MISRAC++2008-7-1-2*/
 /*============================================================================*/
+static void fsmNotifyFcn( stateMachine *m )
+{
+    /*cstat -CERT-EXP36-C_b*/
+    (void)qOS::os.notify( notifyMode::SIMPLE, *static_cast<task*>( m->getOwner() ), nullptr );
+    /*cstat +CERT-EXP36-C_b*/
+}
+/*============================================================================*/
 bool core::addStateMachineTask( task &Task, stateMachine &m, const priority_t p, const qOS::duration_t t, const taskState s, void *arg ) noexcept
 {
     bool retValue = core::addTask( Task, fsmTaskCallback, p, t, task::PERIODIC, s, arg );
@@ -85,9 +92,14 @@ bool core::addStateMachineTask( task &Task, stateMachine &m, const priority_t p,
     if ( retValue ) {
         Task.aObj = &m;
         m.owner = &Task;
+        /*a task attached to the signal-queue is triggered by the queue*/
+        m.xNotifyFcn = &fsmNotifyFcn;
         #if ( Q_QUEUES == 1 )
             if ( nullptr != m.sQueue ) {
                 retValue = Task.attachQueue( *m.sQueue, queueLinkMode::QUEUE_COUNT, 1u );
+                if ( retValue ) {
+                    m.xNotifyFcn = nullptr;
+                }
             }
         #endif
     }
@@ -155,6 +167,7 @@ bool core::setSchedulerReleaseCallback( taskFcn_t callback ) noexcept
 /*============================================================================*/
 bool core::removeTask( task &Task ) noexcept
 {
+    co::_waitCancel( Task ); /*leave any co::semaphore or co::mutex*/
     Task.setFlags( task::BIT_REMOVE_REQUEST, true );
     return true;
 }
@@ -285,6 +298,7 @@ void core::dispatchTaskFillEventInfo( task *Task ) noexcept
                 _Event::EventData = Task->aQueue->peek(); /*the EventData will point to the queue front-data*/
                 break;
             case trigger::byQueueFull: case trigger::byQueueCount: case trigger::byQueueEmpty: // skipcq: CXX-C1001
+            case trigger::byQueueHighWatermark: case trigger::byQueueLowWatermark: // skipcq: CXX-C1001
                 /*the EventData will point to the the linked queue*/
                 _Event::EventData = static_cast<void*>( Task->aQueue );
                 break;
@@ -322,7 +336,7 @@ void core::dispatch( list * const xList ) noexcept
             yieldTask = nullptr;
             _Event::currentTask->activities();
         }
-        
+        resetArenas();
         currentTask = nullptr;
         (void)xList->remove( listPosition::AT_FRONT );
         (void)waitingList.insert( xTask, listPosition::AT_BACK );
@@ -348,9 +362,51 @@ void core::dispatchIdle( void ) noexcept
     _Event::Trigger = trigger::byNoReadyTasks;
     _Event::currentTask = &idle;
     idle.activities();
+    resetArenas();
     bits::multipleSet( flag, BIT_FCALL_IDLE );
 }
 /*============================================================================*/
+void core::resetArenas( void ) noexcept
+{
+    for ( mem::arena *a = arenas ; nullptr != a ; a = a->nextBound ) {
+        a->reset();
+    }
+}
+/*============================================================================*/
+bool core::bindArena( mem::arena &a ) noexcept
+{
+    bool retValue = false;
+    const mem::arena *i = arenas;
+
+    while ( ( nullptr != i ) && ( &a != i ) ) {
+        i = i->nextBound;
+    }
+    if ( nullptr == i ) {
+        a.nextBound = arenas;
+        arenas = &a;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool core::unbindArena( mem::arena &a ) noexcept
+{
+    bool retValue = false;
+    mem::arena **i = &arenas;
+
+    while ( ( nullptr != *i ) && ( &a != *i ) ) {
+        i = &( *i )->nextBound;
+    }
+    if ( nullptr != *i ) {
+        *i = a.nextBound;
+        a.nextBound = nullptr;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
 bool core::run( void ) noexcept
 {
     /*cstat -MISRAC++2008-0-1-6*/
@@ -546,6 +602,11 @@ task* core::getTaskByID( size_t id ) noexcept
     return found;
 }
 /*============================================================================*/
+task* core::getTaskRunning( void ) const noexcept
+{
+    return ( &idle != currentTask ) ? currentTask : nullptr;
+}
+/*============================================================================*/
 bool core::yieldToTask( task &Task ) noexcept
 {
     bool  retValue = false;
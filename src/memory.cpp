@@ -1,6 +1,10 @@
 #include "include/memory.hpp"
 #include "include/helper.hpp"
 
+#if defined( Q_DEFAULT_HEAP_THREAD_CACHE )
+    #include <mutex>
+#endif
+
 using namespace qOS;
 
 
@@ -9,8 +13,167 @@ static const size_t ALLOC_BIT_SEL = ( sizeof(size_t)*static_cast<size_t>( 8u ) )
 static const size_t BLOCK_ALLOCATED_BIT = static_cast<size_t>( 1u ) << ALLOC_BIT_SEL;
 static const size_t HEAP_STRUCT_SIZE = ( sizeof(mem::blockConnect_t) + ( BYTE_ALIGN_MASK - static_cast<size_t>( 1u ) ) ) & ~BYTE_ALIGN_MASK;
 
+/*! @cond */
+/*Two-Level Segregated Fit: the first level splits the sizes in powers of two
+and the second level splits every power of two in TLSF_SL_COUNT ranges*/
+struct mem::tlsfControl {
+    uint32_t flBitmap;
+    uint32_t flCount;
+};
+struct tlsfBlock {
+    tlsfBlock *prevPhys;
+    size_t size; /*the whole block, bit 0 is set when the block is free*/
+    tlsfBlock *nextFree;
+    tlsfBlock *prevFree;
+};
+
+constexpr size_t tlsfLog2( size_t x )
+{
+    return ( x <= 1u ) ? 0u : ( 1u + tlsfLog2( x >> 1u ) );
+}
+
+static const size_t TLSF_ALIGN_BASE = ( static_cast<size_t>( Q_BYTE_ALIGNMENT ) > sizeof(void*) ) ? static_cast<size_t>( Q_BYTE_ALIGNMENT ) : sizeof(void*);
+static const size_t TLSF_ALIGN = ( TLSF_ALIGN_BASE < 4u ) ? 4u : TLSF_ALIGN_BASE;
+static const size_t TLSF_ALIGN_MASK = TLSF_ALIGN - 1u;
+static const size_t TLSF_SL_LOG2 = 4u;
+static const size_t TLSF_SL_COUNT = static_cast<size_t>( 1u ) << TLSF_SL_LOG2;
+static const size_t TLSF_FL_SHIFT = TLSF_SL_LOG2 + tlsfLog2( TLSF_ALIGN );
+static const size_t TLSF_SMALL_BLOCK = static_cast<size_t>( 1u ) << TLSF_FL_SHIFT;
+static const size_t TLSF_HEADER = ( ( 2u*sizeof(void*) ) + TLSF_ALIGN_MASK ) & ~TLSF_ALIGN_MASK;
+static const size_t TLSF_MIN_BLOCK = ( sizeof(tlsfBlock) + TLSF_ALIGN_MASK ) & ~TLSF_ALIGN_MASK;
+static const size_t TLSF_FREE_BIT = 1u;
+
+static size_t tlsfFls( size_t x )
+{
+    size_t r = 0u;
+
+    while ( x > 1u ) {
+        x >>= 1u;
+        ++r;
+    }
+
+    return r;
+}
+static size_t tlsfFfs( const uint32_t x )
+{
+    #if defined( __GNUC__ ) || defined( __clang__ )
+        return static_cast<size_t>( __builtin_ctz( x ) );
+    #else
+        size_t r = 0u;
+
+        while ( 0u == ( x & ( static_cast<uint32_t>( 1u ) << r ) ) ) {
+            ++r;
+        }
+
+        return r;
+    #endif
+}
+static inline size_t tlsfSize( const tlsfBlock *b )
+{
+    return b->size & ~TLSF_FREE_BIT;
+}
+static inline bool tlsfIsFree( const tlsfBlock *b )
+{
+    return 0u != ( b->size & TLSF_FREE_BIT );
+}
+static inline tlsfBlock* tlsfNext( tlsfBlock *b )
+{
+    /*cstat -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+    return reinterpret_cast<tlsfBlock*>( reinterpret_cast<uint8_t*>( b ) + tlsfSize( b ) );
+    /*cstat +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+}
+static inline size_t tlsfHeadsOffset( const size_t flCount )
+{
+    const size_t raw = sizeof(mem::tlsfControl) + ( flCount*sizeof(uint32_t) );
+    return ( raw + sizeof(void*) - 1u ) & ~( sizeof(void*) - 1u );
+}
+static inline size_t tlsfControlSize( const size_t flCount )
+{
+    const size_t raw = tlsfHeadsOffset( flCount ) + ( flCount*TLSF_SL_COUNT*sizeof(tlsfBlock*) );
+    return ( raw + TLSF_ALIGN_MASK ) & ~TLSF_ALIGN_MASK;
+}
+static inline uint32_t* tlsfSlBitmaps( mem::tlsfControl *c )
+{
+    /*cstat -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+    return reinterpret_cast<uint32_t*>( reinterpret_cast<uint8_t*>( c ) + sizeof(mem::tlsfControl) );
+    /*cstat +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+}
+static inline tlsfBlock** tlsfHeads( mem::tlsfControl *c )
+{
+    /*cstat -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+    return reinterpret_cast<tlsfBlock**>( reinterpret_cast<uint8_t*>( c ) + tlsfHeadsOffset( c->flCount ) );
+    /*cstat +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+}
+static void tlsfMapping( const size_t size, size_t &fl, size_t &sl )
+{
+    if ( size < TLSF_SMALL_BLOCK ) {
+        fl = 0u;
+        sl = size >> tlsfLog2( TLSF_ALIGN );
+    }
+    else {
+        const size_t f = tlsfFls( size );
+
+        sl = ( size >> ( f - TLSF_SL_LOG2 ) ) ^ TLSF_SL_COUNT;
+        fl = f - TLSF_FL_SHIFT + 1u;
+    }
+}
+static void tlsfInsert( mem::tlsfControl *c, tlsfBlock *b )
+{
+    size_t fl, sl;
+    tlsfBlock ** const heads = tlsfHeads( c );
+
+    tlsfMapping( tlsfSize( b ), fl, sl );
+    b->size |= TLSF_FREE_BIT;
+    b->prevFree = nullptr;
+    b->nextFree = heads[ ( fl*TLSF_SL_COUNT ) + sl ];
+    if ( nullptr != b->nextFree ) {
+        b->nextFree->prevFree = b;
+    }
+    heads[ ( fl*TLSF_SL_COUNT ) + sl ] = b;
+    c->flBitmap |= ( static_cast<uint32_t>( 1u ) << fl );
+    tlsfSlBitmaps( c )[ fl ] |= ( static_cast<uint32_t>( 1u ) << sl );
+}
+static void tlsfRemove( mem::tlsfControl *c, tlsfBlock *b )
+{
+    size_t fl, sl;
+    tlsfBlock ** const heads = tlsfHeads( c );
+
+    tlsfMapping( tlsfSize( b ), fl, sl );
+    if ( nullptr != b->prevFree ) {
+        b->prevFree->nextFree = b->nextFree;
+    }
+    else {
+        heads[ ( fl*TLSF_SL_COUNT ) + sl ] = b->nextFree;
+        if ( nullptr == b->nextFree ) {
+            uint32_t * const slBitmaps = tlsfSlBitmaps( c );
+
+            slBitmaps[ fl ] &= ~( static_cast<uint32_t>( 1u ) << sl );
+            if ( 0u == slBitmaps[ fl ] ) {
+                c->flBitmap &= ~( static_cast<uint32_t>( 1u ) << fl );
+            }
+        }
+    }
+    if ( nullptr != b->nextFree ) {
+        b->nextFree->prevFree = b->prevFree;
+    }
+    b->size &= ~TLSF_FREE_BIT;
+}
+
+#if ( Q_MEM_DEBUG == 1 )
+struct allocRecord {
+    const char *site;
+    qOS::clock_t tick;
+    size_t sequence;
+    size_t size;
+};
+static const size_t DEBUG_RECORD_SIZE = ( sizeof(allocRecord) + TLSF_ALIGN_MASK ) & ~TLSF_ALIGN_MASK;
+#else
+static const size_t DEBUG_RECORD_SIZE = 0u;
+#endif
+/*! @endcond */
+
 /*============================================================================*/
-bool mem::pool::setup( void *pArea, const size_t pSize ) noexcept
+bool mem::pool::setup( void *pArea, const size_t pSize, const poolPolicy policy ) noexcept
 {
     bool retValue = false;
 
@@ -21,8 +184,18 @@ bool mem::pool::setup( void *pArea, const size_t pSize ) noexcept
         poolMemSize = pSize;
         freeBytesRemaining = pSize;
         end = nullptr;
-        init();
-        retValue = true;
+        control = nullptr;
+        if ( poolPolicy::TLSF == policy ) {
+            retValue = tlsfInit();
+        }
+        else {
+            init();
+            retValue = true;
+        }
+        minEverFree = freeBytesRemaining;
+        nAllocs = 0u;
+        nFrees = 0u;
+        nFailed = 0u;
     }
 
     return retValue;
@@ -59,7 +232,7 @@ void mem::pool::insertBlockIntoFreeList( blockConnect_t *xBlock ) noexcept
     }
 }
 /*============================================================================*/
-void mem::pool::free( void *ptr ) noexcept
+void mem::pool::firstFitFree( void *ptr ) noexcept
 {
     /*cstat -CERT-EXP36-C_b*/
     uint8_t *pToFree = static_cast<uint8_t*>( ptr );
@@ -113,7 +286,7 @@ void mem::pool::init( void ) noexcept
     freeBytesRemaining = firstFreeBlock->blockSize;
 }
 /*============================================================================*/
-void* mem::pool::alloc( size_t pSize ) noexcept
+void* mem::pool::firstFitAlloc( size_t pSize ) noexcept
 {
     void *pAllocated = nullptr;
 
@@ -168,11 +341,308 @@ void* mem::pool::alloc( size_t pSize ) noexcept
     return pAllocated;
 }
 /*============================================================================*/
+bool mem::pool::tlsfInit( void ) noexcept
+{
+    bool retValue = false;
+    /*cstat -CERT-INT36-C*/
+    const mem::address_t address = reinterpret_cast<mem::address_t>( poolMemory );
+    const size_t offset = ( ( address + TLSF_ALIGN_MASK ) & ~TLSF_ALIGN_MASK ) - address;
+    /*cstat +CERT-INT36-C*/
+
+    if ( poolMemSize > offset ) {
+        size_t usable = poolMemSize - offset;
+        size_t flCount, ctlSize;
+
+        if ( ( sizeof(size_t) > 4u ) && ( tlsfFls( usable ) > 30u ) ) {
+            usable = static_cast<size_t>( 0x7FFFFFFFuL ); /*keep the bitmaps in 32 bits*/
+        }
+        flCount = ( tlsfFls( usable ) >= TLSF_FL_SHIFT ) ? ( tlsfFls( usable ) - TLSF_FL_SHIFT + 2u ) : 1u;
+        ctlSize = tlsfControlSize( flCount );
+        if ( usable >= ( ctlSize + TLSF_MIN_BLOCK + TLSF_HEADER ) ) {
+            uint8_t * const base = &poolMemory[ offset ];
+            tlsfBlock *first, *sentinel;
+
+            (void)memset( base, 0, ctlSize );
+            /*cstat -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+            control = reinterpret_cast<mem::tlsfControl*>( base );
+            control->flCount = static_cast<uint32_t>( flCount );
+            first = reinterpret_cast<tlsfBlock*>( &base[ ctlSize ] );
+            first->prevPhys = nullptr;
+            first->size = ( usable - ctlSize - TLSF_HEADER ) & ~TLSF_ALIGN_MASK;
+            sentinel = tlsfNext( first );
+            /*cstat +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+            sentinel->prevPhys = first;
+            sentinel->size = 0u; /*a used block that is never released*/
+            tlsfInsert( control, first );
+            freeBytesRemaining = tlsfSize( first );
+            retValue = true;
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void* mem::pool::tlsfAlloc( const size_t pSize ) noexcept
+{
+    void *pAllocated = nullptr;
+
+    if ( ( pSize > 0u ) && ( pSize < freeBytesRemaining ) ) {
+        size_t need = ( pSize + TLSF_HEADER + TLSF_ALIGN_MASK ) & ~TLSF_ALIGN_MASK;
+        size_t search, fl, sl;
+
+        need = ( need < TLSF_MIN_BLOCK ) ? TLSF_MIN_BLOCK : need;
+        search = need;
+        if ( search >= TLSF_SMALL_BLOCK ) {
+            /*round up to the next list, so any block found there fits*/
+            search += ( static_cast<size_t>( 1u ) << ( tlsfFls( search ) - TLSF_SL_LOG2 ) ) - 1u;
+        }
+        tlsfMapping( search, fl, sl );
+        if ( fl < control->flCount ) {
+            uint32_t * const slBitmaps = tlsfSlBitmaps( control );
+            uint32_t slMap = slBitmaps[ fl ] & ( ~static_cast<uint32_t>( 0u ) << sl );
+
+            if ( 0u == slMap ) {
+                const uint32_t flMap = ( ( fl + 1u ) < 32u ) ? ( control->flBitmap & ( ~static_cast<uint32_t>( 0u ) << ( fl + 1u ) ) ) : 0u;
+
+                if ( 0u != flMap ) {
+                    fl = tlsfFfs( flMap );
+                    slMap = slBitmaps[ fl ];
+                }
+            }
+            if ( 0u != slMap ) {
+                tlsfBlock * const b = tlsfHeads( control )[ ( fl*TLSF_SL_COUNT ) + tlsfFfs( slMap ) ];
+
+                tlsfRemove( control, b );
+                if ( ( b->size - need ) >= TLSF_MIN_BLOCK ) {
+                    /*cstat -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+                    tlsfBlock * const rest = reinterpret_cast<tlsfBlock*>( reinterpret_cast<uint8_t*>( b ) + need );
+                    /*cstat +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+                    rest->size = b->size - need;
+                    rest->prevPhys = b;
+                    tlsfNext( rest )->prevPhys = rest;
+                    b->size = need;
+                    tlsfInsert( control, rest );
+                }
+                freeBytesRemaining -= b->size;
+                /*cstat -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+                pAllocated = static_cast<void*>( reinterpret_cast<uint8_t*>( b ) + TLSF_HEADER );
+                /*cstat +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+            }
+        }
+    }
+
+    return pAllocated;
+}
+/*============================================================================*/
+void mem::pool::tlsfFree( void *ptr ) noexcept
+{
+    /*cstat -CERT-EXP36-C_b*/
+    uint8_t * const pToFree = static_cast<uint8_t*>( ptr );
+    /*cstat +CERT-EXP36-C_b*/
+
+    if ( ( pToFree > &poolMemory[ TLSF_HEADER ] ) && ( pToFree < &poolMemory[ poolMemSize ] ) ) {
+        /*cstat -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+        tlsfBlock *b = reinterpret_cast<tlsfBlock*>( pToFree - TLSF_HEADER );
+        /*cstat +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+        if ( ( !tlsfIsFree( b ) ) && ( b->size > 0u ) ) {
+            tlsfBlock *neighbour = b->prevPhys;
+
+            freeBytesRemaining += b->size;
+            /*coalesce with the physical neighbours*/
+            if ( ( nullptr != neighbour ) && tlsfIsFree( neighbour ) ) {
+                tlsfRemove( control, neighbour );
+                neighbour->size += b->size;
+                b = neighbour;
+            }
+            neighbour = tlsfNext( b );
+            if ( tlsfIsFree( neighbour ) ) {
+                tlsfRemove( control, neighbour );
+                b->size += neighbour->size;
+            }
+            tlsfNext( b )->prevPhys = b;
+            tlsfInsert( control, b );
+        }
+    }
+}
+/*============================================================================*/
+void* mem::pool::rawAlloc( size_t pSize ) noexcept
+{
+    return ( nullptr != control ) ? tlsfAlloc( pSize ) : firstFitAlloc( pSize );
+}
+/*============================================================================*/
+void mem::pool::rawFree( void *ptr ) noexcept
+{
+    if ( nullptr != control ) {
+        tlsfFree( ptr );
+    }
+    else {
+        firstFitFree( ptr );
+    }
+}
+/*============================================================================*/
+void* mem::pool::alloc( size_t pSize, const char *site ) noexcept
+{
+    void *pAllocated = nullptr;
+
+    if ( pSize > 0u ) {
+        #if ( Q_MEM_DEBUG == 1 )
+            if ( pSize <= ( ( ~static_cast<size_t>( 0u ) ) - DEBUG_RECORD_SIZE ) ) {
+                /*cstat -CERT-EXP36-C_b*/
+                uint8_t * const raw = static_cast<uint8_t*>( rawAlloc( pSize + DEBUG_RECORD_SIZE ) );
+                /*cstat +CERT-EXP36-C_b*/
+                if ( nullptr != raw ) {
+                    allocRecord r;
+
+                    r.site = site;
+                    r.tick = clock::getTick();
+                    r.sequence = nAllocs;
+                    r.size = pSize;
+                    (void)memcpy( raw, &r, sizeof(allocRecord) );
+                    pAllocated = &raw[ DEBUG_RECORD_SIZE ];
+                }
+            }
+        #else
+            Q_UNUSED( site );
+            pAllocated = rawAlloc( pSize );
+        #endif
+        if ( nullptr != pAllocated ) {
+            ++nAllocs;
+            if ( freeBytesRemaining < minEverFree ) {
+                minEverFree = freeBytesRemaining;
+            }
+        }
+        else {
+            ++nFailed;
+        }
+    }
+
+    return pAllocated;
+}
+/*============================================================================*/
+void mem::pool::free( void *ptr ) noexcept
+{
+    if ( nullptr != ptr ) {
+        const size_t before = freeBytesRemaining;
+        /*cstat -CERT-EXP36-C_b*/
+        uint8_t * const raw = static_cast<uint8_t*>( ptr ) - DEBUG_RECORD_SIZE;
+        /*cstat +CERT-EXP36-C_b*/
+        rawFree( raw );
+        if ( before != freeBytesRemaining ) { /*invalid pointers are ignored*/
+            ++nFrees;
+        }
+    }
+}
+/*============================================================================*/
+size_t mem::pool::scan( walkFcn_t fcn, void *arg, poolStats *s ) const noexcept
+{
+    size_t live = 0u;
+    uint8_t *block = nullptr;
+    size_t header = HEAP_STRUCT_SIZE;
+    /*cstat -CERT-INT36-C -CERT-EXP39-C_d -CERT-EXP36-C_a*/
+    if ( nullptr != control ) {
+        block = reinterpret_cast<uint8_t*>( control ) + tlsfControlSize( control->flCount );
+        header = TLSF_HEADER;
+    }
+    else if ( nullptr != end ) {
+        const mem::address_t address = reinterpret_cast<mem::address_t>( poolMemory );
+        block = reinterpret_cast<uint8_t*>( ( address + BYTE_ALIGN_MASK ) & ~BYTE_ALIGN_MASK );
+    }
+    else {
+        /*the pool is not initialized*/
+    }
+    while ( nullptr != block ) {
+        size_t size;
+        bool used;
+
+        if ( nullptr != control ) {
+            const tlsfBlock * const b = reinterpret_cast<const tlsfBlock*>( block );
+            size = tlsfSize( b );
+            used = !tlsfIsFree( b );
+        }
+        else {
+            const mem::blockConnect_t * const b = reinterpret_cast<const mem::blockConnect_t*>( block );
+            size = b->blockSize & ~BLOCK_ALLOCATED_BIT;
+            used = ( 0u != ( b->blockSize & BLOCK_ALLOCATED_BIT ) );
+        }
+        /*cstat +CERT-INT36-C +CERT-EXP39-C_d +CERT-EXP36-C_a*/
+        if ( ( 0u == size ) || ( reinterpret_cast<uint8_t*>( end ) == block ) ) {
+            break; /*the end of the heap*/
+        }
+        if ( used ) {
+            ++live;
+            if ( nullptr != fcn ) {
+                blockInfo info;
+
+                info.ptr = &block[ header + DEBUG_RECORD_SIZE ];
+                info.size = size - header - DEBUG_RECORD_SIZE;
+                #if ( Q_MEM_DEBUG == 1 )
+                    allocRecord r;
+
+                    (void)memcpy( &r, &block[ header ], sizeof(allocRecord) );
+                    info.size = r.size;
+                    info.site = r.site;
+                    info.tick = r.tick;
+                    info.sequence = r.sequence;
+                #endif
+                fcn( info, arg );
+            }
+        }
+        else if ( nullptr != s ) {
+            size_t fit = size; /*the part of the block that the policy will grant*/
+            size_t overhead = header + DEBUG_RECORD_SIZE;
+            size_t usable = 0u;
+
+            if ( nullptr == control ) {
+                overhead += static_cast<size_t>( Q_BYTE_ALIGNMENT ); /*first-fit requests always add a full alignment*/
+            }
+            else if ( size >= TLSF_SMALL_BLOCK ) {
+                /*requests are rounded up to the next list*/
+                fit &= ~( ( static_cast<size_t>( 1u ) << ( tlsfFls( size ) - TLSF_SL_LOG2 ) ) - 1u );
+            }
+            else {
+                /*small blocks are not rounded*/
+            }
+            if ( fit > overhead ) {
+                usable = fit - overhead;
+            }
+            ++s->freeBlocks;
+            if ( usable > s->largestFreeBlock ) {
+                s->largestFreeBlock = usable;
+            }
+        }
+        else {
+            /*nothing to do*/
+        }
+        block = &block[ size ];
+    }
+
+    return live;
+}
+/*============================================================================*/
+mem::poolStats mem::pool::getStats( void ) const noexcept
+{
+    poolStats s;
+
+    (void)scan( nullptr, nullptr, &s );
+    s.freeBytes = getFreeSize();
+    s.minEverFreeBytes = minEverFree;
+    s.allocations = nAllocs;
+    s.frees = nFrees;
+    s.failedAllocations = nFailed;
+
+    return s;
+}
+/*============================================================================*/
+size_t mem::pool::walk( walkFcn_t fcn, void *arg ) const noexcept
+{
+    return scan( fcn, arg, nullptr );
+}
+/*============================================================================*/
 size_t mem::pool::getFreeSize( void ) const noexcept
 {
     size_t retValue = poolMemSize;
 
-    if ( nullptr != end ) {
+    if ( ( nullptr != end ) || ( nullptr != control ) ) {
         retValue = freeBytesRemaining;
     }
 
@@ -180,15 +650,447 @@ size_t mem::pool::getFreeSize( void ) const noexcept
 }
 /*============================================================================*/
 
+bool mem::slab::setup( void *pArea, const size_t pSize, const size_t bSize ) noexcept
+{
+    bool retValue = false;
+    size_t size = ( bSize < sizeof(void*) ) ? sizeof(void*) : bSize;
+
+    size = ( size + BYTE_ALIGN_MASK ) & ~BYTE_ALIGN_MASK;
+    if ( nullptr != pArea ) {
+        /*cstat -CERT-INT36-C*/
+        const mem::address_t address = reinterpret_cast<mem::address_t>( pArea );
+        const size_t offset = ( ( address + BYTE_ALIGN_MASK ) & ~BYTE_ALIGN_MASK ) - address;
+        /*cstat +CERT-INT36-C*/
+
+        if ( pSize > offset ) {
+            const size_t n = ( pSize - offset )/size;
+
+            if ( n > 0u ) {
+                /*cstat -CERT-EXP36-C_b*/
+                first = static_cast<uint8_t*>( pArea ) + offset;
+                /*cstat +CERT-EXP36-C_b*/
+                last = &first[ ( n - 1u )*size ];
+                blockSize = size;
+                nBlocks = n;
+                nFree = 0u;
+                freeList = nullptr;
+                for ( size_t i = n ; i > 0u ; --i ) {
+                    void * const block = &first[ ( i - 1u )*size ];
+                    (void)memcpy( block, &freeList, sizeof(void*) );
+                    freeList = block;
+                }
+                nFree = n;
+                retValue = true;
+            }
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void* mem::slab::alloc( void ) noexcept
+{
+    void * const block = freeList;
+
+    if ( nullptr != block ) {
+        (void)memcpy( &freeList, block, sizeof(void*) );
+        --nFree;
+    }
+
+    return block;
+}
+/*============================================================================*/
+void mem::slab::free( void *ptr ) noexcept
+{
+    if ( owns( ptr ) ) {
+        /*cstat -CERT-EXP36-C_b*/
+        const size_t offset = static_cast<size_t>( static_cast<uint8_t*>( ptr ) - first );
+        /*cstat +CERT-EXP36-C_b*/
+        if ( ( 0u == ( offset % blockSize ) ) && ( nFree < nBlocks ) ) {
+            (void)memcpy( ptr, &freeList, sizeof(void*) );
+            freeList = ptr;
+            ++nFree;
+        }
+    }
+}
+/*============================================================================*/
+bool mem::slab::owns( const void *ptr ) const noexcept
+{
+    /*cstat -CERT-EXP36-C_b*/
+    const uint8_t * const p = static_cast<const uint8_t*>( ptr );
+    /*cstat +CERT-EXP36-C_b*/
+    return ( nullptr != p ) && ( nullptr != first ) && ( p >= first ) && ( p <= last );
+}
+/*============================================================================*/
+size_t mem::slab::getBlockSize( void ) const noexcept
+{
+    return blockSize;
+}
+/*============================================================================*/
+size_t mem::slab::getFreeBlocks( void ) const noexcept
+{
+    return nFree;
+}
+/*============================================================================*/
+size_t mem::slab::getTotalBlocks( void ) const noexcept
+{
+    return nBlocks;
+}
+/*============================================================================*/
+bool mem::slabHeap::addClass( slab &s ) noexcept
+{
+    bool retValue = false;
+    slab **iterator = &classes;
+    const slab *c = classes;
+
+    while ( ( nullptr != c ) && ( &s != c ) ) {
+        c = c->nextClass;
+    }
+    if ( ( s.blockSize > 0u ) && ( nullptr == c ) ) {
+        /*keep the classes sorted by block size*/
+        while ( ( nullptr != *iterator ) && ( ( *iterator )->blockSize < s.blockSize ) ) {
+            iterator = &( *iterator )->nextClass;
+        }
+        s.nextClass = *iterator;
+        *iterator = &s;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void* mem::slabHeap::alloc( const size_t pSize ) noexcept
+{
+    void *pAllocated = nullptr;
+
+    if ( pSize > 0u ) {
+        slab *c = classes;
+
+        while ( ( nullptr != c ) && ( c->blockSize < pSize ) ) {
+            c = c->nextClass;
+        }
+        /*spill over to the larger classes when the best fit is exhausted*/
+        while ( ( nullptr != c ) && ( nullptr == pAllocated ) ) {
+            pAllocated = c->alloc();
+            c = c->nextClass;
+        }
+        if ( ( nullptr == pAllocated ) && ( nullptr != fallback ) ) {
+            pAllocated = fallback->alloc( pSize );
+        }
+    }
+
+    return pAllocated;
+}
+/*============================================================================*/
+void mem::slabHeap::free( void *ptr ) noexcept
+{
+    if ( nullptr != ptr ) {
+        slab *c = classes;
+
+        while ( ( nullptr != c ) && ( !c->owns( ptr ) ) ) {
+            c = c->nextClass;
+        }
+        if ( nullptr != c ) {
+            c->free( ptr );
+        }
+        else if ( nullptr != fallback ) {
+            fallback->free( ptr );
+        }
+        else {
+            /*nothing to do*/
+        }
+    }
+}
+/*============================================================================*/
+bool mem::arena::setup( void *pArea, const size_t pSize ) noexcept
+{
+    bool retValue = false;
+
+    if ( nullptr != pArea ) {
+        /*cstat -CERT-INT36-C*/
+        const mem::address_t address = reinterpret_cast<mem::address_t>( pArea );
+        const size_t adjust = ( ( address + BYTE_ALIGN_MASK ) & ~BYTE_ALIGN_MASK ) - address;
+        /*cstat +CERT-INT36-C*/
+
+        if ( pSize > adjust ) {
+            /*cstat -CERT-EXP36-C_b*/
+            base = static_cast<uint8_t*>( pArea ) + adjust;
+            /*cstat +CERT-EXP36-C_b*/
+            size = pSize - adjust;
+            offset = 0u;
+            peak = 0u;
+            retValue = true;
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void* mem::arena::alloc( const size_t pSize ) noexcept
+{
+    void *pAllocated = nullptr;
+
+    if ( ( pSize > 0u ) && ( pSize <= ( size - offset ) ) ) {
+        const size_t next = ( offset + pSize + BYTE_ALIGN_MASK ) & ~BYTE_ALIGN_MASK;
+
+        pAllocated = &base[ offset ];
+        offset = ( next < size ) ? next : size;
+        if ( offset > peak ) {
+            peak = offset;
+        }
+    }
+
+    return pAllocated;
+}
+/*============================================================================*/
+size_t mem::arena::mark( void ) const noexcept
+{
+    return offset;
+}
+/*============================================================================*/
+bool mem::arena::rewind( const size_t m ) noexcept
+{
+    bool retValue = false;
+
+    if ( m <= offset ) {
+        offset = m;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void mem::arena::reset( void ) noexcept
+{
+    offset = 0u;
+}
+/*============================================================================*/
+size_t mem::arena::getFreeSize( void ) const noexcept
+{
+    return size - offset;
+}
+/*============================================================================*/
+size_t mem::arena::getPeak( void ) const noexcept
+{
+    return peak;
+}
+/*============================================================================*/
+
 #if ( Q_DEFAULT_HEAP_SIZE >= 64 )
 
 static uint8_t defaultPoolMemory[ Q_DEFAULT_HEAP_SIZE ] = { 0 };
 static mem::pool defaultMemPool( defaultPoolMemory, Q_DEFAULT_HEAP_SIZE );
+static mem::outOfMemoryFcn_t outOfMemoryHook = nullptr; // skipcq: CXX-W2009
 
 /*============================================================================*/
+void mem::setOutOfMemoryHook( outOfMemoryFcn_t fcn ) noexcept
+{
+    outOfMemoryHook = fcn;
+}
+/*============================================================================*/
+
+#if defined( Q_DEFAULT_HEAP_THREAD_CACHE )
+
+/*! @cond */
+/*Small requests are served from per-thread free lists of a few size classes,
+so the shared pool and its lock are only touched to move blocks in batches.
+Every block carries a header with its class to route the unsized delete*/
+static std::mutex defaultHeapLock; // skipcq: CXX-W2009
+static const size_t CACHE_CLASSES = 5u;
+static const size_t CACHE_CLASS_SIZE[ CACHE_CLASSES ] = { 16u, 32u, 64u, 128u, 256u };
+static const size_t CACHE_BATCH = 16u;
+static const size_t CACHE_LARGE = CACHE_CLASSES;
+static const size_t CACHE_HEADER = ( sizeof(size_t) + BYTE_ALIGN_MASK ) & ~BYTE_ALIGN_MASK;
+
+static size_t cacheClass( const size_t size )
+{
+    size_t c = 0u;
+
+    while ( ( c < CACHE_CLASSES ) && ( CACHE_CLASS_SIZE[ c ] < size ) ) {
+        ++c;
+    }
+
+    return c;
+}
+
+class threadCache {
+    private:
+        uint8_t *heads[ CACHE_CLASSES ] = {};
+        size_t counts[ CACHE_CLASSES ] = {};
+        inline void push( const size_t c, uint8_t *raw ) noexcept
+        {
+            (void)memcpy( &raw[ CACHE_HEADER ], &heads[ c ], sizeof(uint8_t*) );
+            heads[ c ] = raw;
+            ++counts[ c ];
+        }
+        inline uint8_t* pop( const size_t c ) noexcept
+        {
+            uint8_t * const raw = heads[ c ];
+
+            (void)memcpy( &heads[ c ], &raw[ CACHE_HEADER ], sizeof(uint8_t*) );
+            --counts[ c ];
+
+            return raw;
+        }
+        void flush( const size_t c, size_t n ) noexcept
+        {
+            std::lock_guard<std::mutex> lock( defaultHeapLock );
+
+            while ( ( n > 0u ) && ( nullptr != heads[ c ] ) ) {
+                defaultMemPool.free( pop( c ) );
+                --n;
+            }
+        }
+        bool refill( const size_t c ) noexcept
+        {
+            std::lock_guard<std::mutex> lock( defaultHeapLock );
+
+            for ( size_t i = 0u ; i < CACHE_BATCH ; ++i ) {
+                /*cstat -CERT-EXP36-C_b*/
+                uint8_t * const raw = static_cast<uint8_t*>( defaultMemPool.alloc( CACHE_CLASS_SIZE[ c ] + CACHE_HEADER ) );
+                /*cstat +CERT-EXP36-C_b*/
+                if ( nullptr == raw ) {
+                    break;
+                }
+                (void)memcpy( raw, &c, sizeof(size_t) );
+                push( c, raw );
+            }
+
+            return ( nullptr != heads[ c ] );
+        }
+    public:
+        threadCache() = default;
+        ~threadCache()
+        {
+            (void)release();
+        }
+        uint8_t* take( const size_t c ) noexcept
+        {
+            uint8_t *raw = nullptr;
+
+            if ( ( nullptr != heads[ c ] ) || refill( c ) ) {
+                raw = pop( c );
+            }
+
+            return raw;
+        }
+        void give( const size_t c, uint8_t *raw ) noexcept
+        {
+            push( c, raw );
+            if ( counts[ c ] > ( 2u*CACHE_BATCH ) ) {
+                flush( c, CACHE_BATCH );
+            }
+        }
+        bool release( void ) noexcept
+        {
+            bool released = false;
+
+            for ( size_t c = 0u ; c < CACHE_CLASSES ; ++c ) {
+                released = released || ( counts[ c ] > 0u );
+                flush( c, counts[ c ] );
+            }
+
+            return released;
+        }
+};
+static thread_local threadCache cache; // skipcq: CXX-W2009
+/*! @endcond */
+
+/*============================================================================*/
+static void* defaultHeapAlloc( size_t size ) noexcept
+{
+    void *pAllocated = nullptr;
+    bool retry;
+
+    size = ( 0u == size ) ? 1u : size;
+    do {
+        const size_t c = cacheClass( size );
+        uint8_t *raw = nullptr;
+
+        if ( c < CACHE_CLASSES ) {
+            raw = cache.take( c );
+        }
+        else if ( size <= ( ( ~static_cast<size_t>( 0u ) ) - CACHE_HEADER ) ) {
+            std::lock_guard<std::mutex> lock( defaultHeapLock );
+            /*cstat -CERT-EXP36-C_b*/
+            raw = static_cast<uint8_t*>( defaultMemPool.alloc( size + CACHE_HEADER ) );
+            /*cstat +CERT-EXP36-C_b*/
+            if ( nullptr != raw ) {
+                (void)memcpy( raw, &CACHE_LARGE, sizeof(size_t) );
+            }
+        }
+        else {
+            /*the request can not be represented*/
+        }
+        retry = false;
+        if ( nullptr != raw ) {
+            pAllocated = &raw[ CACHE_HEADER ];
+        }
+        else {
+            /*give back the cached blocks of this thread before asking the hook*/
+            retry = cache.release() || ( ( nullptr != outOfMemoryHook ) && outOfMemoryHook( size ) );
+        }
+    } while ( retry );
+
+    return pAllocated;
+}
+/*============================================================================*/
+static void defaultHeapFree( void *ptr, const size_t c ) noexcept
+{
+    /*cstat -CERT-EXP36-C_b*/
+    uint8_t * const raw = static_cast<uint8_t*>( ptr ) - CACHE_HEADER;
+    /*cstat +CERT-EXP36-C_b*/
+    if ( c < CACHE_CLASSES ) {
+        cache.give( c, raw );
+    }
+    else {
+        std::lock_guard<std::mutex> lock( defaultHeapLock );
+        defaultMemPool.free( raw );
+    }
+}
+/*============================================================================*/
+static size_t defaultHeapClass( void *ptr ) noexcept
+{
+    size_t c;
+    /*cstat -CERT-EXP36-C_b*/
+    (void)memcpy( &c, static_cast<uint8_t*>( ptr ) - CACHE_HEADER, sizeof(size_t) );
+    /*cstat +CERT-EXP36-C_b*/
+    return c;
+}
+/*============================================================================*/
+
+#else
+
+/*============================================================================*/
+static void* defaultHeapAlloc( size_t size ) noexcept
+{
+    void *pAllocated;
+
+    size = ( 0u == size ) ? 1u : size;
+    do {
+        pAllocated = defaultMemPool.alloc( size );
+    } while ( ( nullptr == pAllocated ) && ( nullptr != outOfMemoryHook ) && outOfMemoryHook( size ) );
+
+    return pAllocated;
+}
+/*============================================================================*/
+static void defaultHeapFree( void *ptr, const size_t c ) noexcept
+{
+    Q_UNUSED( c );
+    defaultMemPool.free( ptr );
+}
+/*============================================================================*/
+static size_t defaultHeapClass( void *ptr ) noexcept
+{
+    Q_UNUSED( ptr );
+    return 0u;
+}
+/*============================================================================*/
+#endif /*Q_DEFAULT_HEAP_THREAD_CACHE*/
+
 void * operator new(size_t size)
 {
-    return defaultMemPool.alloc( size );
+    return defaultHeapAlloc( size );
 }
 /*============================================================================*/
 void * operator new[]( size_t size )
@@ -197,6 +1099,7 @@ void * operator new[]( size_t size )
 }
 /*============================================================================*/
 /*cstat -MISRAC++2008-7-1-2 -MISRAC++2008-0-1-11 -CPU-delete-void*/
+#if !defined( Q_DEFAULT_HEAP_THREAD_CACHE )
 void * operator new( size_t size, void *place ) noexcept
 {
     /* Nothing to do */
@@ -209,9 +1112,12 @@ void * operator new[]( size_t size, void *place ) noexcept
     return operator new(size, place);
 }
 /*============================================================================*/
+#endif
 void operator delete( void * ptr ) noexcept
 {
-    defaultMemPool.free( ptr );
+    if ( nullptr != ptr ) {
+        defaultHeapFree( ptr, defaultHeapClass( ptr ) );
+    }
 }
 /*============================================================================*/
 void operator delete[](void * ptr) noexcept
@@ -219,6 +1125,23 @@ void operator delete[](void * ptr) noexcept
     operator delete( ptr );
 }
 /*============================================================================*/
+void operator delete( void *ptr, size_t size ) noexcept
+{
+    if ( nullptr != ptr ) {
+        #if defined( Q_DEFAULT_HEAP_THREAD_CACHE )
+            defaultHeapFree( ptr, cacheClass( size ) ); /*no need to decode the header*/
+        #else
+            defaultHeapFree( ptr, size );
+        #endif
+    }
+}
+/*============================================================================*/
+void operator delete[]( void *ptr, size_t size ) noexcept
+{
+    operator delete( ptr, size );
+}
+/*============================================================================*/
+#if !defined( Q_DEFAULT_HEAP_THREAD_CACHE )
 void operator delete(void* ptr, void* place) noexcept
 {
     (void)ptr; 
@@ -232,6 +1155,7 @@ void operator delete[](void* ptr, void* place) noexcept
     (void)place; // unused
     /*Nothing to do*/
 }
+#endif
 /*cstat +MISRAC++2008-7-1-2 +MISRAC++2008-0-1-11 +CPU-delete-void*/
 /*============================================================================*/
 #endif /*Q_USE_MEM_ALLOCATION_SCHEME*/
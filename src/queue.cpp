@@ -1,5 +1,6 @@
 #include "include/queue.hpp"
 #include "include/critical.hpp"
+#include "include/task.hpp"
 
 using namespace qOS;
 
@@ -30,6 +31,7 @@ void queue::reset( void ) noexcept
     writer = head;
     reader = head + ( ( itemsCount - 1u )*itemSize );
     /*cstat +CERT-INT30-C_a*/
+    afterRemove();
     critical::exit();
 }
 /*============================================================================*/
@@ -61,6 +63,27 @@ void queue::moveReader( void ) noexcept
     }
 }
 /*============================================================================*/
+uint8_t* queue::front( void ) const noexcept
+{
+    uint8_t *f = reader + itemSize;
+
+    if ( f >= tail ) {
+        f = head;
+    }
+
+    return f;
+}
+/*============================================================================*/
+uint8_t* queue::advance( uint8_t *p, const size_t n ) const noexcept
+{
+    /*cstat -CERT-INT30-C_a*/
+    const size_t offset = static_cast<size_t>( p - head ) + ( n*itemSize );
+    const size_t length = itemsCount*itemSize;
+
+    return head + ( ( offset >= length ) ? ( offset - length ) : offset );
+    /*cstat +CERT-INT30-C_a*/
+}
+/*============================================================================*/
 bool queue::removeFront( void ) noexcept
 {
     bool retValue = false;
@@ -71,6 +94,7 @@ bool queue::removeFront( void ) noexcept
     if ( waiting > 0u ) {
         moveReader();
         --itemsWaiting;
+        afterRemove();
         retValue = true;
     }
     critical::exit();
@@ -94,6 +118,7 @@ bool queue::receive( void *dst ) noexcept
     if ( waiting > 0u ) {
         copyDataFromQueue( dst );
         --itemsWaiting;
+        afterRemove();
         retValue = true;
     }
     critical::exit();
@@ -129,8 +154,12 @@ bool queue::send( void *itemToQueue, const queueSendMode pos ) noexcept
         critical::enter();
         if ( itemsWaiting < itemsCount ) {
             copyDataToQueue( itemToQueue, pos );
+            afterSend( 1u, 0u );
             retValue = true;
         }
+        else {
+            afterSend( 0u, 1u );
+        }
         critical::exit();
     }
 
@@ -165,3 +194,198 @@ size_t queue::getItemSize( void ) const noexcept
     return itemSize;
 }
 /*============================================================================*/
+size_t queue::sendMany( const void *src, const size_t n ) noexcept
+{
+    size_t k = 0u;
+
+    if ( nullptr != src ) {
+        critical::enter();
+        k = itemsCount - itemsWaiting;
+        k = ( n < k ) ? n : k;
+        if ( k > 0u ) {
+            const size_t contiguous = static_cast<size_t>( tail - writer )/itemSize;
+            const size_t first = ( k < contiguous ) ? k : contiguous;
+            /*cstat -CERT-EXP36-C_b*/
+            const uint8_t * const s = static_cast<const uint8_t*>( src );
+            /*cstat +CERT-EXP36-C_b*/
+            (void)memcpy( static_cast<void*>( writer ), s, first*itemSize );
+            (void)memcpy( static_cast<void*>( head ), &s[ first*itemSize ], ( k - first )*itemSize );
+            writer = advance( writer, k );
+            itemsWaiting += k;
+        }
+        afterSend( k, n - k );
+        critical::exit();
+    }
+
+    return k;
+}
+/*============================================================================*/
+size_t queue::receiveMany( void *dst, const size_t n ) noexcept
+{
+    size_t k = 0u;
+
+    if ( nullptr != dst ) {
+        critical::enter();
+        k = itemsWaiting;
+        k = ( n < k ) ? n : k;
+        if ( k > 0u ) {
+            const uint8_t * const f = front();
+            const size_t contiguous = static_cast<size_t>( tail - f )/itemSize;
+            const size_t first = ( k < contiguous ) ? k : contiguous;
+            /*cstat -CERT-EXP36-C_b*/
+            uint8_t * const d = static_cast<uint8_t*>( dst );
+            /*cstat +CERT-EXP36-C_b*/
+            (void)memcpy( d, f, first*itemSize );
+            (void)memcpy( &d[ first*itemSize ], head, ( k - first )*itemSize );
+            reader = advance( reader, k );
+            itemsWaiting -= k;
+            afterRemove();
+        }
+        critical::exit();
+    }
+
+    return k;
+}
+/*============================================================================*/
+void* queue::reserve( size_t &n ) noexcept
+{
+    void *region = nullptr;
+    size_t k;
+
+    critical::enter();
+    k = itemsCount - itemsWaiting;
+    critical::exit();
+    if ( k > 0u ) {
+        const size_t contiguous = static_cast<size_t>( tail - writer )/itemSize;
+
+        k = ( k < contiguous ) ? k : contiguous;
+    }
+    n = ( n < k ) ? n : k;
+    if ( n > 0u ) {
+        region = static_cast<void*>( writer );
+    }
+
+    return region;
+}
+/*============================================================================*/
+bool queue::commit( const size_t n ) noexcept
+{
+    bool retValue = false;
+
+    critical::enter();
+    if ( ( n > 0u ) && ( n <= ( itemsCount - itemsWaiting ) ) ) {
+        writer = advance( writer, n );
+        itemsWaiting += n;
+        afterSend( n, 0u );
+        retValue = true;
+    }
+    critical::exit();
+
+    return retValue;
+}
+/*============================================================================*/
+void* queue::peek( size_t &n ) noexcept
+{
+    void *region = nullptr;
+    uint8_t *f;
+
+    critical::enter();
+    n = itemsWaiting;
+    f = front();
+    critical::exit();
+    if ( n > 0u ) {
+        const size_t contiguous = static_cast<size_t>( tail - f )/itemSize;
+
+        n = ( n < contiguous ) ? n : contiguous;
+        region = static_cast<void*>( f );
+    }
+
+    return region;
+}
+/*============================================================================*/
+bool queue::release( const size_t n ) noexcept
+{
+    bool retValue = false;
+
+    critical::enter();
+    if ( ( n > 0u ) && ( n <= itemsWaiting ) ) {
+        reader = advance( reader, n );
+        itemsWaiting -= n;
+        afterRemove();
+        retValue = true;
+    }
+    critical::exit();
+
+    return retValue;
+}
+/*============================================================================*/
+void queue::afterSend( const size_t sent, const size_t dropped ) noexcept
+{
+    const size_t level = itemsWaiting;
+
+    enqueued += static_cast<uint32_t>( sent );
+    overflows += static_cast<uint32_t>( dropped );
+    if ( level > peak ) {
+        peak = level;
+    }
+    if ( ( wmHigh > 0u ) && ( !wmAbove ) && ( level >= wmHigh ) ) {
+        wmAbove = true;
+        if ( nullptr != wmTask ) {
+            wmTask->watermarkEdge( true ); /*trigger the attached task*/
+        }
+    }
+}
+/*============================================================================*/
+void queue::afterRemove( void ) noexcept
+{
+    if ( ( wmHigh > 0u ) && wmAbove && ( itemsWaiting <= wmLow ) ) {
+        wmAbove = false;
+        if ( nullptr != wmTask ) {
+            wmTask->watermarkEdge( false );
+        }
+    }
+}
+/*============================================================================*/
+bool queue::setWatermarks( const size_t high, const size_t low ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( high > 0u ) && ( high <= itemsCount ) && ( low < high ) ) {
+        critical::enter();
+        wmHigh = high;
+        wmLow = low;
+        wmAbove = ( count() >= high );
+        if ( nullptr != wmTask ) {
+            wmTask->wmEdges = 0u;
+        }
+        critical::exit();
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+size_t queue::getPeak( void ) const noexcept
+{
+    return peak;
+}
+/*============================================================================*/
+uint32_t queue::getOverflowCount( void ) const noexcept
+{
+    return overflows;
+}
+/*============================================================================*/
+uint32_t queue::getTotalEnqueued( void ) const noexcept
+{
+    return enqueued;
+}
+/*============================================================================*/
+void queue::resetStats( void ) noexcept
+{
+    critical::enter();
+    peak = count();
+    overflows = 0u;
+    enqueued = 0u;
+    critical::exit();
+}
+/*============================================================================*/
@@ -0,0 +1,243 @@
+/*the ucontext routines require the X/Open interfaces on macOS*/
+#if defined( __APPLE__ ) && !defined( _XOPEN_SOURCE )
+    #define _XOPEN_SOURCE   600
+#endif
+
+#include "include/stackful.hpp"
+
+#if defined( Q_CO_STACKFUL_AVAILABLE )
+
+#include <ucontext.h>
+
+using namespace qOS;
+
+/*! @cond  */
+static const uint8_t STACKFUL_IDLE = 0u;
+static const uint8_t STACKFUL_READY = 1u;
+static const uint8_t STACKFUL_SUSPENDED = 2u;
+static const uint8_t STACKFUL_RUNNING = 3u;
+static const uint8_t STACKFUL_FINISHED = 4u;
+static const size_t STACK_ALIGN_MASK = 15u;
+/*! @endcond  */
+
+co::stackful *co::stackful::running = nullptr; // skipcq: CXX-W2009
+
+/*============================================================================*/
+bool co::stackPool::setup( void *pArea, const size_t areaSize, const size_t sSize ) noexcept
+{
+    bool retValue = false;
+    const size_t blockSize = ( sSize + STACK_ALIGN_MASK ) & ~STACK_ALIGN_MASK;
+
+    if ( ( nullptr != pArea ) && ( blockSize >= sizeof(void*) ) ) {
+        /*cstat -CERT-INT36-C*/
+        const size_t address = reinterpret_cast<size_t>( pArea );
+        const size_t offset = ( ( address + STACK_ALIGN_MASK ) & ~STACK_ALIGN_MASK ) - address;
+        /*cstat +CERT-INT36-C*/
+
+        if ( areaSize > offset ) {
+            /*cstat -CERT-EXP36-C_b*/
+            uint8_t * const base = static_cast<uint8_t*>( pArea ) + offset;
+            /*cstat +CERT-EXP36-C_b*/
+            const size_t n = ( areaSize - offset )/blockSize;
+
+            freeList = nullptr;
+            nFree = 0u;
+            stackSize = blockSize;
+            for ( size_t i = n ; i > 0u ; --i ) {
+                give( &base[ ( i - 1u )*blockSize ] );
+            }
+            retValue = ( n > 0u );
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void* co::stackPool::take( void ) noexcept
+{
+    void *s = freeList;
+
+    if ( nullptr != s ) {
+        (void)memcpy( &freeList, s, sizeof(void*) );
+        --nFree;
+    }
+
+    return s;
+}
+/*============================================================================*/
+void co::stackPool::give( void *s ) noexcept
+{
+    if ( nullptr != s ) {
+        (void)memcpy( s, &freeList, sizeof(void*) );
+        freeList = s;
+        ++nFree;
+    }
+}
+/*============================================================================*/
+size_t co::stackPool::getStackSize( void ) const noexcept
+{
+    return stackSize;
+}
+/*============================================================================*/
+size_t co::stackPool::available( void ) const noexcept
+{
+    return nFree;
+}
+/*============================================================================*/
+co::stackful::~stackful()
+{
+    releaseStack();
+}
+/*============================================================================*/
+bool co::stackful::setup( stackfulFcn_t f, void *a, stackPool &p ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != f ) && ( STACKFUL_RUNNING != status ) ) {
+        releaseStack();
+        stack = nullptr; /*a dedicated stack is not owned by the pool*/
+        fcn = f;
+        arg = a;
+        pool = &p;
+        stackSize = p.getStackSize();
+        status = STACKFUL_READY;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool co::stackful::setup( stackfulFcn_t f, void *a, void *pStack, const size_t sSize ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr != f ) && ( nullptr != pStack ) && ( sSize > 0u ) && ( STACKFUL_RUNNING != status ) ) {
+        releaseStack();
+        fcn = f;
+        arg = a;
+        pool = nullptr;
+        stack = pStack;
+        stackSize = sSize;
+        status = STACKFUL_READY;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void co::stackful::releaseStack( void ) noexcept
+{
+    if ( nullptr != pool ) {
+        pool->give( stack );
+        stack = nullptr;
+    }
+}
+/*============================================================================*/
+void co::stackful::entryPoint( void )
+{
+    stackful * const s = running;
+
+    s->fcn( *s, s->arg );
+    s->status = STACKFUL_FINISHED;
+    /*the uc_link context takes back the control to the resume() caller*/
+}
+/*============================================================================*/
+bool co::stackful::prepare( void ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( nullptr == stack ) && ( nullptr != pool ) ) {
+        stack = pool->take();
+    }
+    if ( ( nullptr != stack ) && ( 0 == getcontext( &ctx ) ) ) {
+        ctx.uc_stack.ss_sp = stack;
+        ctx.uc_stack.ss_size = stackSize;
+        ctx.uc_link = &caller;
+        makecontext( &ctx, &stackful::entryPoint, 0 );
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool co::stackful::resume( void ) noexcept
+{
+    bool retValue = false;
+
+    if ( nullptr == running ) {
+        bool ready = ( STACKFUL_SUSPENDED == status );
+
+        if ( STACKFUL_READY == status ) {
+            ready = prepare();
+        }
+        if ( ready ) {
+            status = STACKFUL_RUNNING;
+            running = this;
+            (void)swapcontext( &caller, &ctx );
+            running = nullptr;
+            if ( STACKFUL_FINISHED == status ) {
+                releaseStack();
+            }
+            else {
+                retValue = true;
+            }
+        }
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+void co::stackful::suspend( void ) noexcept
+{
+    if ( this == running ) {
+        status = STACKFUL_SUSPENDED;
+        (void)swapcontext( &ctx, &caller );
+        status = STACKFUL_RUNNING;
+    }
+}
+/*============================================================================*/
+void co::stackful::sleep( const qOS::duration_t t ) noexcept
+{
+    (void)tm.set( t );
+    do {
+        suspend();
+    } while ( !tm.expired() );
+    tm.disarm();
+}
+/*============================================================================*/
+bool co::stackful::reset( void ) noexcept
+{
+    bool retValue = false;
+
+    if ( ( STACKFUL_IDLE != status ) && ( STACKFUL_RUNNING != status ) ) {
+        releaseStack();
+        tm.disarm();
+        status = STACKFUL_READY;
+        retValue = true;
+    }
+
+    return retValue;
+}
+/*============================================================================*/
+bool co::stackful::isAlive( void ) const noexcept
+{
+    return ( STACKFUL_IDLE != status ) && ( STACKFUL_FINISHED != status );
+}
+/*============================================================================*/
+co::stackful* co::stackful::self( void ) noexcept
+{
+    return running;
+}
+/*============================================================================*/
+void co::stackful::taskCallback( event_t e )
+{
+    /*cstat -CERT-EXP36-C_b*/
+    stackful * const s = static_cast<stackful*>( e.TaskData );
+    /*cstat +CERT-EXP36-C_b*/
+    if ( nullptr != s ) {
+        (void)s->resume();
+    }
+}
+/*============================================================================*/
+
+#endif /*Q_CO_STACKFUL_AVAILABLE*/
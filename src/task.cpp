@@ -17,8 +17,11 @@ const uint32_t task::BIT_QUEUE_COUNT = 0x00000010uL;
 const uint32_t task::BIT_QUEUE_EMPTY = 0x00000020uL;
 const uint32_t task::BIT_SHUTDOWN = 0x00000040uL;
 const uint32_t task::BIT_REMOVE_REQUEST = 0x00000080uL;
+const uint32_t task::BIT_WAIT_GRANTED = 0x00000100uL;
+const uint32_t task::BIT_WAIT_ENABLED = 0x00000200uL;
+const uint32_t task::BIT_QUEUE_WATERMARKS = 0x00000400uL;
 const uint32_t task::EVENT_FLAGS_MASK = 0xFFFFF000uL;
-const uint32_t task::QUEUE_FLAGS_MASK = 0x0000003CuL;
+const uint32_t task::QUEUE_FLAGS_MASK = 0x0000043CuL;
 _Event * task::pEventInfo = nullptr; // skipcq: CXX-W2011, CXX-W2009
 
 /*============================================================================*/
@@ -213,7 +216,17 @@ trigger task::queueCheckEvents( void ) noexcept
         qCount = aQueue->count(); /*to avoid side effects*/
         /*check the queue events in the corresponding precedence order*/
         /*cstat -MISRAC++2008-5-14-1*/
-        if ( fullFlag && aQueue->isFull() ) { /*isFull() is known to not have side effects*/
+        if ( wmEdges > 0u ) { /*crossings are edges, serve them first*/
+            bool rising;
+
+            critical::enter();
+            rising = wmRising;
+            wmRising = !wmRising; /*the edges alternate*/
+            --wmEdges;
+            critical::exit();
+            retValue = rising ? trigger::byQueueHighWatermark : trigger::byQueueLowWatermark;
+        }
+        else if ( fullFlag && aQueue->isFull() ) { /*isFull() is known to not have side effects*/
             retValue = trigger::byQueueFull;
         }
         else if ( ( countFlag ) && ( qCount >= aQueueCount ) ) {
@@ -240,6 +253,26 @@ size_t task::getID( void ) const noexcept
     return entry;
 }
 /*============================================================================*/
+void task::watermarkEdge( const bool rising ) noexcept
+{
+    /*
+    Called by the queue with the interrupts disabled. The edges alternate, so
+    the oldest pending edge and the number of edges describe the whole FIFO.
+    When it is full, the two oldest edges are dropped, so the newest edge
+    still matches the level of the queue.
+    */
+    if ( 0u == wmEdges ) {
+        wmRising = rising;
+        wmEdges = 1u;
+    }
+    else if ( wmEdges < UINT8_MAX ) {
+        ++wmEdges;
+    }
+    else {
+        --wmEdges;
+    }
+}
+/*============================================================================*/
 bool task::attachQueue( queue &q, const queueLinkMode mode, const size_t arg ) noexcept
 {
     bool retValue = false;
@@ -249,6 +282,17 @@ bool task::attachQueue( queue &q, const queueLinkMode mode, const size_t arg ) n
         if ( queueLinkMode::QUEUE_COUNT == mode ) {
             aQueueCount = arg;
         }
+        critical::enter();
+        /*the queue being replaced should not trigger this task anymore*/
+        if ( ( nullptr != aQueue ) && ( &q != aQueue ) && ( this == aQueue->wmTask ) ) {
+            aQueue->wmTask = nullptr;
+            wmEdges = 0u;
+        }
+        if ( queueLinkMode::QUEUE_WATERMARKS == mode ) {
+            q.wmTask = ( arg > 0u ) ? this : nullptr;
+            wmEdges = 0u;
+        }
+        critical::exit();
         aQueue = ( arg > 0u ) ? &q : nullptr;
         retValue = true;
     }